@@ -10,6 +10,11 @@ def get_doc_classes():
     return [
         "Wasm",
         "WasmMemory",
+        "WasmFramebuffer",
+        "WasmModule",
+        "WasmEngineConfig",
+        "AudioStreamWasm",
+        "AudioStreamPlaybackWasm",
     ]
 
 
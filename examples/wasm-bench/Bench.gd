@@ -0,0 +1,93 @@
+extends Node
+
+# Headless microbenchmarks of the Godot Wasm host boundary
+# Usage: godot --headless --path examples/wasm-bench -- --output=bench.json
+
+const MODULES = ["bench", "bench-1000", "bench-10000"]
+const TRANSFER_SIZES = [64, 4096, 65536]
+const ITERATIONS = 10000
+const REPEATS = 10
+
+var results = {}
+
+func _ready():
+	var imports = { "functions": { "env.callback": [self, "callback"] } }
+
+	# Compile and instantiate times per module size
+	for name in MODULES:
+		var bytecode = read_file(name)
+		var instance = Wasm.new()
+		measure("compile/%s" % name, REPEATS, func(): instance.compile(bytecode), { "bytes": bytecode.size() })
+		measure("instantiate/%s" % name, REPEATS, func(): instance.instantiate(imports), { "bytes": bytecode.size() })
+
+	# Export call overhead by arity
+	var wasm = Wasm.new()
+	wasm.load(read_file("bench"), imports)
+	measure("function/arity0", ITERATIONS, func(): wasm.function("nop", []))
+	measure("function/arity1", ITERATIONS, func(): wasm.function("arity1", [1]))
+	measure("function/arity4", ITERATIONS, func(): wasm.function("arity4", [1, 2, 3, 4]))
+	measure("function/arity8", ITERATIONS, func(): wasm.function("arity8", [1, 2, 3, 4, 5, 6, 7, 8]))
+
+	# Import callback, WASI shim, and Node3D shim round trips from within a single export call
+	measure_batched("callback", func(n): wasm.function("callbacks", [n]))
+	measure_batched("wasi/clock_time_get", func(n): wasm.function("wasi_clock", [n]))
+	var node = Node3D.new()
+	add_child(node)
+	measure_batched("shim/node3D_get_position", func(n): wasm.function("node3d_position", [node.get_instance_id(), n]))
+
+	# Memory throughput
+	for size in TRANSFER_SIZES:
+		var data = PackedByteArray()
+		data.resize(size)
+		var meta = { "bytes": size }
+		measure("memory/put_data/%d" % size, ITERATIONS, func(): wasm.memory.seek(0).put_data(data), meta)
+		measure("memory/get_data/%d" % size, ITERATIONS, func(): wasm.memory.seek(0).get_data(size), meta)
+
+	report()
+	get_tree().quit()
+
+func callback(value: int) -> int:
+	return value
+
+func measure(key: String, iterations: int, f: Callable, meta: Dictionary = {}):
+	var start = Time.get_ticks_usec()
+	for i in iterations: f.call()
+	record(key, iterations, Time.get_ticks_usec() - start, meta)
+
+func measure_batched(key: String, f: Callable):
+	# Loop within the module so only boundary crossings are measured
+	var baseline = Time.get_ticks_usec()
+	f.call(0)
+	baseline = Time.get_ticks_usec() - baseline
+	var start = Time.get_ticks_usec()
+	f.call(ITERATIONS)
+	record(key, ITERATIONS, max(Time.get_ticks_usec() - start - baseline, 0))
+
+func record(key: String, iterations: int, usec: int, meta: Dictionary = {}):
+	var result = { "iterations": iterations, "total_usec": usec, "per_iteration_usec": float(usec) / iterations }
+	result.merge(meta)
+	results[key] = result
+
+func report():
+	var output = {
+		"godot": Engine.get_version_info().string,
+		"os": OS.get_name(),
+		"processor": OS.get_processor_name(),
+		"benchmarks": results,
+	}
+	var json = JSON.stringify(output, "\t")
+	print(json)
+	for arg in OS.get_cmdline_user_args():
+		if !arg.begins_with("--output="): continue
+		var file = FileAccess.open(arg.trim_prefix("--output="), FileAccess.WRITE)
+		if file == null:
+			push_error("Failed to write benchmark results")
+			return
+		file.store_string(json)
+		file.close()
+
+func read_file(name: String) -> PackedByteArray:
+	var file = FileAccess.open("res://wasm/%s.wasm" % name, FileAccess.READ)
+	var buffer = file.get_buffer(file.get_length())
+	file.close()
+	return buffer
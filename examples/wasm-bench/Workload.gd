@@ -0,0 +1,99 @@
+extends Node
+
+# Headless end-to-end workloads driving the visualization modules
+# Usage: godot --headless --path examples/wasm-bench res://Workload.tscn -- --label=wasmer-v4.2.0 --output=workload.json
+
+const MODULES_PATH = "../wasm-visualizations/Modules"
+const SIZES: PackedVector2Array = [Vector2(50, 50), Vector2(100, 100), Vector2(200, 200), Vector2(400, 400), Vector2(800, 800), Vector2(1600, 1600)]
+const MODULES: PackedStringArray = ["interference", "mandelbrot", "life", "wave", "sort"]
+const TICKS = 120
+
+var results = {}
+
+func _ready():
+	var imports = { "functions": {
+		"env.abort": [self, "_abort"],
+		"env.draw_image": [self, "_draw_image"],
+		"env.draw_pixel": [self, "_draw_pixel"],
+		"env.seed": [self, "_seed"],
+	} }
+	var args = user_args()
+
+	for module in MODULES:
+		var bytecode = read_file(module)
+		for size in SIZES:
+			var wasm = Wasm.new()
+			var start = Time.get_ticks_usec()
+			wasm.compile(bytecode)
+			var compile_usec = Time.get_ticks_usec() - start
+			start = Time.get_ticks_usec()
+			wasm.instantiate(imports)
+			var instantiate_usec = Time.get_ticks_usec() - start
+			wasm.function("resize", [int(size.x), int(size.y)])
+
+			# Time each update tick
+			var ticks = PackedFloat64Array()
+			var peak = 0
+			for tick in TICKS:
+				start = Time.get_ticks_usec()
+				wasm.function("update", [tick, tick / 60.0])
+				ticks.append((Time.get_ticks_usec() - start) / 1000.0)
+				if wasm.memory: peak = max(peak, wasm.memory.inspect().get("current", 0))
+			ticks.sort()
+
+			results["%s/%dx%d" % [module, size.x, size.y]] = {
+				"compile_ms": compile_usec / 1000.0,
+				"instantiate_ms": instantiate_usec / 1000.0,
+				"tick_p50_ms": percentile(ticks, 0.5),
+				"tick_p99_ms": percentile(ticks, 0.99),
+				"memory_peak_bytes": peak,
+			}
+
+	var output = {
+		"label": args.get("label", "unlabelled"),
+		"godot": Engine.get_version_info().string,
+		"os": OS.get_name(),
+		"processor": OS.get_processor_name(),
+		"ticks": TICKS,
+		"process_memory_peak_bytes": OS.get_static_memory_peak_usage(),
+		"workloads": results,
+	}
+	var json = JSON.stringify(output, "\t")
+	print(json)
+	if args.has("output"):
+		var file = FileAccess.open(args.output, FileAccess.WRITE)
+		if file == null: push_error("Failed to write workload results")
+		else: file.store_string(json)
+	get_tree().quit()
+
+func percentile(sorted: PackedFloat64Array, p: float) -> float:
+	if sorted.is_empty(): return 0.0
+	return sorted[min(int(ceil(p * sorted.size())) - 1, sorted.size() - 1)]
+
+func user_args() -> Dictionary:
+	var args = {}
+	for arg in OS.get_cmdline_user_args():
+		var pair = arg.trim_prefix("--").split("=", true, 1)
+		if pair.size() == 2: args[pair[0]] = pair[1]
+	return args
+
+func read_file(name: String) -> PackedByteArray:
+	var path = ProjectSettings.globalize_path("res://").path_join(MODULES_PATH).path_join("%s.wasm" % name)
+	var file = FileAccess.open(path, FileAccess.READ)
+	var buffer = file.get_buffer(file.get_length())
+	file.close()
+	return buffer
+
+# Wasm module imports; drawing is excluded from guest timings
+
+func _abort(a: int, b: int, c: int, d: int) -> void:
+	push_error("Abort from Wasm module: %d %d %d %d" % [a, b, c, d])
+
+func _draw_image(_p: int, _s: int) -> void:
+	pass
+
+func _draw_pixel(_x: int, _y: int, _r: int, _g: int, _b: int, _a: int) -> void:
+	pass
+
+func _seed() -> float:
+	return randf()
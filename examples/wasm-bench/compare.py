@@ -0,0 +1,39 @@
+#!/usr/bin/env python
+"""Compare workload results across runtime builds
+
+Usage: python compare.py workload-wasmer-v4.2.0.json workload-wasmtime-v12.0.1.json
+"""
+import json
+import sys
+
+METRICS = ["compile_ms", "instantiate_ms", "tick_p50_ms", "tick_p99_ms", "memory_peak_bytes"]
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def main(paths):
+    if len(paths) < 1:
+        sys.exit(__doc__)
+    reports = [load(p) for p in paths]
+    labels = [r.get("label", p) for r, p in zip(reports, paths)]
+    workloads = sorted(set().union(*(r["workloads"].keys() for r in reports)))
+    for metric in METRICS:
+        print("\n### {}\n".format(metric))
+        print("| workload | " + " | ".join(labels) + (" | delta |" if len(reports) > 1 else " |"))
+        print("|---" * (len(labels) + 1 + (len(reports) > 1)) + "|")
+        for workload in workloads:
+            values = [r["workloads"].get(workload, {}).get(metric) for r in reports]
+            cells = ["-" if v is None else "{:.3f}".format(v) if isinstance(v, float) else str(v) for v in values]
+            row = "| {} | {} |".format(workload, " | ".join(cells))
+            if len(reports) > 1 and values[0] and values[-1] is not None:
+                row += " {:+.1f}% |".format((values[-1] - values[0]) / values[0] * 100)
+            elif len(reports) > 1:
+                row += " - |"
+            print(row)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -22,13 +22,10 @@ func _gui_input(event: InputEvent): # Unfocus input
 		if focus_owner: focus_owner.release_focus()
 
 func _load_wasm(path: String):
-	var file = FileAccess.open(path, FileAccess.READ)
-	var buffer = file.get_buffer(file.get_length())
 	var imports = { # Import format module.name
 		"functions": { "index.callback": [self, "callback"] },
 	}
-	wasm.load(buffer, imports)
-	file.close()
+	wasm.load_file(path, imports)
 	_update_info()
 
 func callback(value: int):
@@ -0,0 +1,67 @@
+extends GodotWasmTestSuite
+
+const SIGNAL = Vector2(0.5, -0.5)
+
+func test_audio_mix():
+	var playback = load_stream().instantiate_playback()
+	# Silent until started
+	expect_eq(playback.mix_frames(4), silence(4))
+	playback.start()
+	expect(playback.is_playing())
+	# Mixed over several calls to the module's 512 frame buffer
+	expect_eq(playback.mix_frames(1200), frames(SIGNAL, 1200))
+	playback.stop()
+	expect(!playback.is_playing())
+	expect_eq(playback.mix_frames(4), silence(4))
+	# Resumed with existing instance
+	playback.start()
+	expect_eq(playback.mix_frames(4), frames(SIGNAL, 4))
+
+func test_audio_trap():
+	var stream = load_stream()
+	# Module traps when requested more than 512 frames
+	stream.buffer_frames = 1024
+	var playback = stream.instantiate_playback()
+	playback.start()
+	expect_eq(playback.mix_frames(1024), silence(1024))
+	expect_error("Audio stream process failed")
+	expect(!playback.is_playing())
+
+func test_audio_contention():
+	var playback = load_stream().instantiate_playback()
+	playback.start()
+	# Mix on another thread while the instance is repeatedly locked by start
+	var blocks = []
+	var thread = Thread.new()
+	thread.start(func(): for i in 64: blocks.append(playback.mix_frames(64)))
+	while thread.is_alive(): playback.start()
+	thread.wait_to_finish()
+	# Each block is either generated or silence if the instance was busy but never torn
+	expect_eq(blocks.size(), 64)
+	for block in blocks: expect(block == frames(SIGNAL, 64) or block == silence(64))
+
+func test_invalid_audio_stream():
+	var stream = load_stream()
+	stream.buffer_global = "missing"
+	var playback = stream.instantiate_playback()
+	playback.start()
+	expect_error("Unknown global name missing")
+	expect_error("Invalid audio buffer global missing")
+	expect(!playback.is_playing())
+	expect_eq(playback.mix_frames(4), silence(4))
+
+# Audio utils
+
+func load_stream() -> AudioStreamWasm:
+	var stream = AudioStreamWasm.new()
+	stream.bytecode = read_file("audio")
+	return stream
+
+func frames(v: Vector2, count: int) -> PackedVector2Array:
+	var result = PackedVector2Array()
+	result.resize(count)
+	result.fill(v)
+	return result
+
+func silence(count: int) -> PackedVector2Array:
+	return frames(Vector2(), count)
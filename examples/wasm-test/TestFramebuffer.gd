@@ -0,0 +1,53 @@
+extends GodotWasmTestSuite
+
+const OFFSET = 1024
+const SIZE = 16
+
+func test_framebuffer_register():
+	var wasm = load_wasm("framebuffer")
+	expect_eq(wasm.framebuffer.texture, null)
+	expect_eq(wasm.function("register", [OFFSET, SIZE, SIZE]), 0)
+	var texture = wasm.framebuffer.texture
+	expect_ne(texture, null)
+	expect_eq(texture.get_size(), Vector2(SIZE, SIZE))
+	# Unchanged region retains texture
+	expect_eq(wasm.function("register", [OFFSET, SIZE, SIZE]), 0)
+	expect_eq(wasm.framebuffer.texture, texture)
+
+func test_invalid_framebuffer():
+	var wasm = load_wasm("framebuffer")
+	# 16x16 pixels span OFFSET bytes so end one byte past the single page
+	expect_eq(wasm.function("register", [PAGE_SIZE - OFFSET + 1, SIZE, SIZE]), null)
+	expect_error("Framebuffer out of bounds")
+	expect_error("Failed calling function register")
+	expect_eq(wasm.function("register", [OFFSET, 0, SIZE]), null)
+	expect_error("Invalid framebuffer size")
+	expect_error("Failed calling function register")
+
+func test_framebuffer_dirty():
+	var wasm = load_wasm("framebuffer")
+	wasm.function("register", [OFFSET, SIZE, SIZE])
+	# Nothing to flush until a region is reported
+	expect_eq(wasm.framebuffer.flush(), false)
+	var pixels = PackedByteArray()
+	pixels.resize(SIZE * 4)
+	pixels.fill(0xFF)
+	wasm.memory.seek(OFFSET).put_data(pixels)
+	expect_eq(wasm.function("dirty", [0, 0, SIZE, 1]), 0)
+	expect_eq(wasm.framebuffer.flush(), true)
+	expect_eq(wasm.framebuffer.flush(), false)
+	# Regions outside the framebuffer are clipped away
+	wasm.function("dirty", [SIZE, SIZE, 4, 4])
+	expect_eq(wasm.framebuffer.flush(), false)
+
+func test_framebuffer_flush():
+	var wasm = load_wasm("framebuffer")
+	wasm.function("register", [OFFSET, SIZE, SIZE])
+	# Many regions in a frame merged and flushed once
+	for i in SIZE: wasm.framebuffer.mark_dirty(Rect2i(i, i, 1, 1))
+	expect_eq(wasm.framebuffer.flush(), true)
+	expect_eq(wasm.framebuffer.flush(), false)
+	# Unbound framebuffer has nothing to flush
+	var framebuffer = WasmFramebuffer.new()
+	framebuffer.mark_dirty(Rect2i(0, 0, 1, 1))
+	expect_eq(framebuffer.flush(), false)
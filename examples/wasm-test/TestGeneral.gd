@@ -23,6 +23,9 @@ func test_instantiate():
 	error = wasm.instantiate({})
 	expect_eq(error, OK)
 	expect_empty()
+	# Instantiation requires compilation
+	expect_eq(Wasm.new().instantiate({}), ERR_UNCONFIGURED)
+	expect_error("Not compiled")
 
 func test_multi_instantiate():
 	var wasm = Wasm.new()
@@ -41,6 +44,107 @@ func test_load():
 	expect_eq(error, OK)
 	expect_empty()
 
+func test_load_file():
+	var wasm = Wasm.new()
+	var error = wasm.load_file("res://wasm/simple.wasm", {})
+	expect_eq(error, OK)
+	expect_eq(wasm.function("add", [1, 2]), 3)
+	error = wasm.compile_file("res://wasm/missing.wasm")
+	expect_eq(error, ERR_FILE_CANT_OPEN)
+	expect_error("Failed to open file res://wasm/missing.wasm")
+
+func test_compressed():
+	for format in ["gzip", "zstd"]:
+		var wasm = Wasm.new()
+		var error = wasm.load(read_file("simple-%s" % format), {})
+		expect_eq(error, OK)
+		expect_eq(wasm.function("add", [1, 2]), 3)
+		error = wasm.load_file("res://wasm/simple-%s.wasm" % format, {})
+		expect_eq(error, OK)
+		expect_eq(wasm.function("add", [3, 4]), 7)
+	# Frame content size mismatch
+	var wasm = Wasm.new()
+	var buffer = read_file("simple-zstd")
+	buffer[5] += 1
+	var error = wasm.compile(buffer)
+	expect_eq(error, ERR_INVALID_DATA)
+	expect_error("Decompression failed")
+
+func test_module_resource():
+	var module = ResourceLoader.load("res://wasm/simple.wasm")
+	expect_type(module, TYPE_OBJECT)
+	expect_eq(module.get_class(), "WasmModule")
+	expect_eq(module.precompiled, false)
+	# Instances share resource module
+	for i in 2:
+		var wasm = Wasm.new()
+		var error = wasm.load_module(module, {})
+		expect_eq(error, OK)
+		expect_eq(wasm.function("add", [i, 2]), i + 2)
+	# Precompiled artifact deserialized in place of compilation
+	var native = WasmModule.precompile(read_file("simple"))
+	expect_ne(native.size(), 0)
+	module = WasmModule.new()
+	expect_eq(module.compile(read_file("simple"), native), OK)
+	expect_eq(module.precompiled, true)
+	var wasm = Wasm.new()
+	expect_eq(wasm.load_module(module, {}), OK)
+	expect_eq(wasm.function("add", [3, 4]), 7)
+	# Incompatible artifact falls back to bytecode
+	expect_eq(module.compile(read_file("simple"), Utils.to_utf8("asdf")), OK)
+	expect_eq(module.precompiled, false)
+
+func test_tiered():
+	var wasm = Wasm.new()
+	wasm.tiered = true
+	var error = wasm.load(read_file("simple"), {})
+	expect_eq(error, OK)
+	expect_eq(wasm.function("add", [1, 2]), 3)
+	wasm.add_monitors("WasmTiered")
+	# Optimized instance replaces baseline instance between calls
+	for i in 100:
+		if wasm.optimized: break
+		OS.delay_msec(10)
+		expect_eq(wasm.function("add", [i, 2]), i + 2)
+	expect_eq(wasm.optimized, true)
+	expect_eq(wasm.function("add", [3, 4]), 7)
+	# Monitors retained across tiers
+	expect_eq(Performance.has_custom_monitor("WasmTiered/add calls"), true)
+	wasm.remove_monitors()
+
+func test_tiered_state():
+	var wasm = Wasm.new()
+	wasm.tiered = true
+	expect_eq(wasm.load(read_file("marshal"), {}), OK)
+	# Allocator mutates an unexported global which would be reset by replacing the instance
+	var heap = wasm.function("malloc", [16])
+	for i in 20:
+		OS.delay_msec(10)
+		expect_eq(wasm.function("malloc", [16]), heap + 16 * (i + 1))
+	# Remains on baseline tier
+	expect_eq(wasm.optimized, false)
+	# Exported table elements can not be transferred either
+	wasm = Wasm.new()
+	wasm.tiered = true
+	expect_eq(wasm.load(read_file("table"), { "globals": { "env.base": 10 } }), OK)
+	for i in 20:
+		OS.delay_msec(10)
+		expect_eq(wasm.function("increment", []), i + 1)
+	expect_eq(wasm.optimized, false)
+
+func test_engine_config():
+	var settings = WasmEngineConfig.get_settings()
+	expect_eq(settings["features/simd"], ProjectSettings.get_setting("wasm/engine/features/simd"))
+	expect_eq(WasmEngineConfig.get_setting("compiler"), ProjectSettings.get_setting("wasm/engine/compiler"))
+	# Engine created by first compilation rather than construction; already created by earlier tests
+	Wasm.new()
+	load_wasm("simple")
+	expect(WasmEngineConfig.is_locked())
+	expect_eq(WasmEngineConfig.set_setting("features/simd", false), ERR_LOCKED)
+	expect_error("Engine configuration locked once engine is created")
+	expect_eq(WasmEngineConfig.set_setting("invalid", false), ERR_INVALID_PARAMETER)
+	expect_error("Unknown engine setting invalid")
+
 func test_invalid_binary():
 	var wasm = Wasm.new()
 	var buffer = Utils.to_utf8("asdf")
@@ -112,6 +216,16 @@ func test_callback_function():
 	wasm.function("callback", [])
 	expect_log("Dummy import 123")
 
+func test_linked_imports():
+	var simple = load_wasm("simple")
+	var wasm = load_wasm("link", { "modules": { "simple": simple } })
+	expect_eq(wasm.function("add3", [1, 2, 3]), 6)
+	# Linked instance must provide each import of its module
+	load_wasm("link", { "modules": { "simple": load_wasm("memory") } }, ERR_CANT_CREATE)
+	expect_error("Missing linked export simple.add")
+	load_wasm("link", { "modules": { "simple": Wasm.new() } }, ERR_CANT_CREATE)
+	expect_error("Invalid linked instance simple")
+
 func test_global():
 	var wasm = load_wasm("simple")
 	var global_const = wasm.global("global_const")
@@ -134,6 +248,62 @@ func test_uninstantiated_global():
 	expect_eq(result, null)
 	expect_error("Not instantiated")
 
+func test_set_global():
+	var wasm = load_wasm("table", { "globals": { "env.base": 10 } })
+	expect_eq(wasm.global("counter"), 0)
+	expect_eq(wasm.set_global("counter", 5), OK)
+	expect_eq(wasm.function("increment", []), 6)
+	expect_eq(wasm.global("counter"), 6)
+	expect_eq(wasm.set_global("limit", 1), ERR_UNAVAILABLE)
+	expect_error("Immutable global limit")
+	expect_eq(wasm.global("limit"), 100)
+
+func test_import_global():
+	var wasm = Wasm.new()
+	var error = wasm.compile(read_file("table"))
+	expect_eq(error, OK)
+	expect_eq(wasm.inspect().import_globals, { "env.base": [TYPE_INT, false] })
+	expect_eq(wasm.inspect().export_tables, { "table": [3, TABLE_MAX] })
+	load_wasm("table", {}, ERR_CANT_CREATE)
+	expect_error("Missing import global env.base")
+	load_wasm("table", { "globals": { "env.base": "asdf" } }, ERR_CANT_CREATE)
+	expect_error("Unsupported Godot variant type")
+	expect_error("Invalid import global env.base")
+
+func test_call_indirect():
+	var wasm = load_wasm("table", { "globals": { "env.base": 10 } })
+	var result = wasm.call_indirect("table", 0, [1])
+	if result == null:
+		# Only the Wasmer C API lacks table element access; any other failure logs a different error
+		expect_error("Table elements unsupported by Wasmer C API")
+		skip("Table elements unsupported by Wasmer C API")
+		return
+	expect_eq(result, 11)
+	expect_eq(wasm.call_indirect("table", 0, [2]), 12) # Cached context
+	expect_eq(wasm.call_indirect("table", 1, [4]), 8)
+	expect_eq(wasm.call_indirect("table", 2, [4]), null)
+	expect_error("Null function reference")
+	expect_eq(wasm.call_indirect("table", 3, [4]), null)
+	expect_error("Table index out of bounds")
+
+func test_call_indirect_import():
+	# Imported table created with declared size and populated by element segment
+	var wasm = Wasm.new()
+	var error = wasm.compile(read_file("table-import"))
+	expect_eq(error, OK)
+	var inspect = wasm.inspect()
+	expect_eq(inspect.import_tables, { "env.table": [2, TABLE_MAX] })
+	expect_eq(inspect.export_tables, { "table": [2, TABLE_MAX] })
+	error = wasm.instantiate({})
+	if error == ERR_UNAVAILABLE:
+		expect_error("Import table env.table must be linked; table creation unsupported by Wasmer C API")
+		skip("Table creation unsupported by Wasmer C API")
+		return
+	expect_eq(error, OK)
+	expect_eq(wasm.call_indirect("table", 0, []), 7)
+	expect_eq(wasm.call_indirect("table", 1, []), null)
+	expect_error("Null function reference")
+
 func test_inspect():
 	# Simple module pre-compile
 	var wasm = Wasm.new()
@@ -147,10 +317,13 @@ func test_inspect():
 	inspect = wasm.inspect()
 	var expected = {
 		"import_functions": {},
+		"import_globals": {},
+		"import_tables": {},
 		"export_globals": {
 			"global_const": [TYPE_FLOAT, false],
 			"global_mut": [TYPE_INT, true],
 		},
+		"export_tables": {},
 		"export_functions": {
 			"_initialize": [[], []],
 			"add": [[TYPE_INT, TYPE_INT], [TYPE_INT]]
@@ -166,7 +339,10 @@ func test_inspect():
 		"import_functions": {
 			"import.test_import": [[TYPE_INT], []],
 		},
+		"import_globals": {},
+		"import_tables": {},
 		"export_globals": {},
+		"export_tables": {},
 		"export_functions": {
 			"_initialize": [[], []],
 			"callback": [[], []],
@@ -179,3 +355,125 @@ func test_inspect():
 	}
 	expect_eq(inspect, expected)
 	expect_empty()
+
+func test_stats():
+	var imports = { "functions": { "env.transform": [self, "transform"] } }
+	var wasm = load_wasm("flatten", imports)
+	# Disabled by default
+	wasm.function("swizzle", [1.0, 2.0, 3.0])
+	expect_eq(wasm.get_stats(), { "exports": {}, "imports": {}, "memory": {} })
+	# Exports and imports
+	wasm.stats_enabled = true
+	wasm.function("swizzle", [1.0, 2.0, 3.0])
+	wasm.function("call_transform", [1.0, 2.0, 3.0])
+	wasm.function("call_transform", [1.0, 2.0, 3.0])
+	var stats = wasm.get_stats()
+	expect_eq(stats.exports.keys(), ["call_transform", "swizzle"])
+	expect_eq(stats.exports.call_transform.calls, 2)
+	expect_eq(stats.exports.swizzle.calls, 1)
+	expect_eq(stats.imports["env.transform"].calls, 2)
+	expect_eq(wasm.get_stat("exports", "call_transform", "calls"), 2)
+	# Sub-microsecond calls timed
+	expect(stats.exports.swizzle.total_nsec > 0)
+	expect_eq(stats.exports.swizzle.total_nsec, stats.exports.swizzle.max_nsec)
+	expect_eq(stats.exports.swizzle.total_usec, stats.exports.swizzle.total_nsec / 1000)
+	# Performance monitors
+	wasm.add_monitors("WasmTest")
+	expect_eq(Performance.has_custom_monitor("WasmTest/swizzle calls"), true)
+	expect_eq(Performance.get_custom_monitor("WasmTest/swizzle calls"), 1)
+	# Prefix already used by another instance
+	var other = load_wasm("flatten", imports)
+	other.add_monitors("WasmTest")
+	expect_error("Monitor WasmTest/.+ already registered")
+	other.remove_monitors()
+	expect_eq(Performance.has_custom_monitor("WasmTest/swizzle calls"), true)
+	wasm.remove_monitors()
+	expect_eq(Performance.has_custom_monitor("WasmTest/swizzle calls"), false)
+	# Reset
+	wasm.reset_stats()
+	expect_eq(wasm.get_stats().exports, {})
+
+func test_profiling():
+	var imports = { "functions": { "env.transform": [self, "transform_slow"] } }
+	var wasm = load_wasm("flatten", imports)
+	var error = wasm.start_profiling(1000)
+	expect_eq(error, OK)
+	error = wasm.start_profiling(1000)
+	expect_eq(error, ERR_ALREADY_IN_USE)
+	expect_error("Already profiling")
+	wasm.function("call_transform", [1.0, 2.0, 3.0])
+	var profile: String = wasm.stop_profiling()
+	expect_eq(profile.contains("call_transform;env.transform "), true)
+	expect_eq(wasm.stop_profiling(), "")
+	expect_error("Not profiling")
+
+func test_profiling_trap():
+	var wasm = load_wasm("audio")
+	wasm.start_profiling(1000)
+	# Module traps when requested more than 512 frames
+	expect_eq(wasm.function("process", [1024, 1024]), null)
+	expect_error("Failed calling function process")
+	var profile: String = wasm.stop_profiling()
+	# Trap backtraces kept apart from timing samples
+	var traps = Array(profile.split("\n", false)).filter(func(l): return l.begins_with("[trap];process"))
+	expect_eq(traps.size(), 1)
+	expect_eq(traps[0].ends_with(" 1"), true)
+
+var profiled: Wasm
+
+func test_profiling_callback():
+	var imports = { "functions": { "env.transform": [self, "transform_stop_profiling"] } }
+	var wasm = load_wasm("flatten", imports)
+	profiled = wasm
+	wasm.start_profiling(1000)
+	# Stopped within import callback while export frame remains on stack
+	var result = wasm.function("call_transform", [1.0, 2.0, 3.0])
+	expect_ne(result, null)
+	expect_eq(wasm.stop_profiling(), "")
+	expect_error("Not profiling")
+	# Restarted after stopped profiler released
+	expect_eq(wasm.start_profiling(1000), OK)
+	profiled = null
+	wasm.function("call_transform", [1.0, 2.0, 3.0])
+	expect_eq(wasm.stop_profiling().contains("call_transform;env.transform"), true)
+
+func transform_stop_profiling(x: float, y: float, z: float):
+	if profiled: profiled.stop_profiling()
+	OS.delay_msec(20)
+	return [x, y, z]
+
+func transform(x: float, y: float, z: float):
+	return [x, y, z]
+
+func transform_slow(x: float, y: float, z: float):
+	OS.delay_msec(20)
+	return [x, y, z]
+
+func test_tracing():
+	var wasm = load_wasm("simple")
+	Wasm.start_tracing()
+	wasm.function("add", [1, 2])
+	Wasm.stop_tracing()
+	wasm.function("add", [3, 4])
+	var error = Wasm.dump_trace("user://trace.json")
+	expect_eq(error, OK)
+	var trace = JSON.parse_string(FileAccess.get_file_as_string("user://trace.json"))
+	var events = trace.traceEvents.map(func(e): return [e.name, e.ph])
+	expect_eq(events, [["add", "B"], ["add", "E"]])
+
+func test_tracing_restart():
+	var wasm = load_wasm("simple")
+	var other = load_wasm("simple")
+	# Events recorded on another thread while tracing is restarted
+	var thread = Thread.new()
+	thread.start(func(): for i in 1000: other.function("add", [i, i]))
+	while thread.is_alive(): Wasm.start_tracing()
+	thread.wait_to_finish()
+	# Restart discards earlier events without resetting buffers owned by other threads
+	Wasm.start_tracing()
+	wasm.function("add", [1, 2])
+	Wasm.stop_tracing()
+	expect_eq(Wasm.dump_trace("user://trace.json"), OK)
+	var trace = JSON.parse_string(FileAccess.get_file_as_string("user://trace.json"))
+	var events = trace.traceEvents.map(func(e): return [e.name, e.ph])
+	expect_eq(events, [["add", "B"], ["add", "E"]])
@@ -0,0 +1,43 @@
+extends GodotWasmTestSuite
+
+func test_marshal_bytes():
+	var wasm = load_wasm("marshal")
+	var result = wasm.function("sum_bytes", [PackedByteArray([1, 2, 3, 4])])
+	expect_eq(result, 10)
+	expect_eq(wasm.function_typed("echo", [PackedByteArray([1, 2, 3, 4])], TYPE_PACKED_BYTE_ARRAY), PackedByteArray([1, 2, 3, 4]))
+	# Scratch memory released on return such that repeated calls do not exhaust it
+	var bytes = PackedByteArray(range(256))
+	for i in 512: expect_eq(wasm.function_typed("echo", [bytes], TYPE_PACKED_BYTE_ARRAY), bytes)
+
+func test_marshal_string():
+	var wasm = load_wasm("marshal")
+	expect_eq(wasm.function("sum_bytes", ["AB"]), 131)
+	expect_eq(wasm.function_typed("echo", ["Hello, Wasm!"], TYPE_STRING), "Hello, Wasm!")
+	expect_eq(wasm.function_typed("first", ["Hello"], TYPE_STRING), "Hello")
+	# Length in bytes of multibyte UTF-8
+	expect_eq(wasm.function_typed("echo", ["Grüße ✓"], TYPE_STRING), "Grüße ✓")
+	expect_eq(wasm.function_typed("echo", [&"name"], TYPE_STRING_NAME), &"name")
+
+func test_marshal_floats():
+	var wasm = load_wasm("marshal")
+	expect_eq(wasm.function("sum_floats", [PackedFloat32Array([1.5, 2.5, 3.0])]), 7.0)
+	expect_eq(wasm.function("sum_floats", [Vector3(1.0, 2.0, 4.0)]), 7.0)
+	expect_eq(wasm.function_typed("first", [Vector3(1.0, 2.0, 4.0)], TYPE_VECTOR3), Vector3(1.0, 2.0, 4.0))
+	expect_eq(wasm.function_typed("echo", [PackedFloat32Array([1.5, 2.5])], TYPE_PACKED_FLOAT32_ARRAY), PackedFloat32Array([1.5, 2.5]))
+
+func test_marshal_scratch():
+	var wasm = load_wasm("marshal")
+	var error = wasm.set_scratch(256, 64)
+	expect_eq(error, OK)
+	expect_eq(wasm.function_typed("echo", [PackedByteArray([5, 6, 7])], TYPE_PACKED_BYTE_ARRAY), PackedByteArray([5, 6, 7]))
+	expect_eq(wasm.function_typed("echo", ["Scratch"], TYPE_STRING), "Scratch")
+	expect_eq(wasm.function_typed("first", [Vector3(1.0, 2.0, 4.0)], TYPE_VECTOR3), Vector3(1.0, 2.0, 4.0))
+	# Arguments exceeding scratch memory
+	expect_eq(wasm.function("sum_bytes", [PackedByteArray(range(128))]), null)
+	expect_error("Scratch memory exhausted")
+
+func test_marshal_missing_allocator():
+	var wasm = load_wasm("marshal")
+	wasm.allocator = "missing"
+	expect_eq(wasm.function("sum_bytes", ["A"]), null)
+	expect_error("Missing allocator export missing")
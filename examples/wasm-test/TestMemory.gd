@@ -8,10 +8,13 @@ func test_inspect_compiled():
 	var inspect = wasm.inspect()
 	var expected = {
 		"import_functions": {},
+		"import_globals": {},
+		"import_tables": {},
 		"export_globals": {
 			"global_const": [TYPE_FLOAT, false],
 			"global_mut": [TYPE_INT, true],
 		},
+		"export_tables": {},
 		"export_functions": {
 			"_initialize": [[], []],
 			"add": [[TYPE_INT, TYPE_INT], [TYPE_INT]]
@@ -133,3 +136,43 @@ func test_resize():
 	wasm.function("resize", [PAGE_SIZE])
 	memory = wasm.inspect().get("memory").get("current")
 	expect_eq(memory, PAGE_SIZE * 3)
+
+func test_memory_grown():
+	var wasm = load_wasm("memory")
+	var grown = []
+	wasm.memory.memory_grown.connect(func(old_pages, new_pages): grown.append([old_pages, new_pages]))
+	# Growth by the module observed on return
+	wasm.function("resize", [PAGE_SIZE])
+	expect_eq(grown, [[1, 3]])
+	# Growth by the host rounded up by growth factor
+	wasm.memory.growth_factor = 2.0
+	expect_eq(wasm.memory.grow(1), OK)
+	expect_eq(grown, [[1, 3], [3, 6]])
+	expect_eq(wasm.memory.grow(0), OK)
+	expect_eq(grown, [[1, 3], [3, 6]])
+	# Maximum applied to created memory
+	var memory = WasmMemory.new()
+	memory.max_pages = 2
+	expect_eq(memory.grow(3), ERR_PARAMETER_RANGE_ERROR)
+	expect_error("Memory exceeds maximum pages")
+	expect_eq(memory.grow(1), OK)
+	expect_eq(memory.inspect().get("max"), PAGE_SIZE * 2)
+	expect_eq(memory.grow(1), OK)
+	expect_eq(memory.grow(1), FAILED)
+
+func test_memory_backing():
+	var wasm = load_wasm("memory", { "memory_backing": { "prefault": -1 } })
+	if OS.get_name() != "Windows": expect(wasm.memory.get_resident_size() >= PAGE_SIZE)
+	# Whole pages mapped and remainder copied
+	var data = PackedByteArray()
+	for i in 8200: data.append(i % 251)
+	var file = FileAccess.open("user://blob.bin", FileAccess.WRITE)
+	file.store_buffer(data)
+	file.close()
+	expect_eq(wasm.memory.map_file("user://blob.bin", 0), OK)
+	expect_eq(wasm.memory.seek(0).get_data(data.size())[1], data)
+	# Writes are private to memory
+	wasm.memory.seek(0).put_u8(255)
+	expect_eq(FileAccess.get_file_as_bytes("user://blob.bin"), data)
+	expect_eq(wasm.memory.map_file("user://blob.bin", PAGE_SIZE - 8), ERR_PARAMETER_RANGE_ERROR)
+	expect_error("Memory region out of bounds")
@@ -60,3 +60,39 @@ func test_share_memory():
 	wasm_a.function("store_byte", [0xFF, 0])
 	var result = wasm_b.function("load_byte", [0])
 	expect_eq(result, 0xFF)
+
+func test_link_memory():
+	var wasm_a = load_wasm("memory")
+	expect_eq(wasm_a.memory.grow(99), OK) # Minimum of import memory
+	var wasm_b = load_wasm("memory-import", { "modules": { "env": wasm_a } })
+	wasm_a.memory.seek(0).put_u8(0xFF)
+	expect_eq(wasm_b.memory.seek(0).get_u8(), 0xFF)
+	expect_eq(wasm_b.memory.inspect(), wasm_a.memory.inspect())
+
+func test_copy_memory():
+	var wasm_a = load_wasm("memory")
+	var wasm_b = load_wasm("memory")
+	var data = PackedByteArray([1, 2, 3, 4, 5, 6, 7, 8])
+	wasm_a.memory.seek(16).put_data(data)
+	# Copy between instances
+	expect_eq(wasm_b.memory.copy_from(wasm_a.memory, 16, 32, data.size()), OK)
+	expect_eq(wasm_b.memory.seek(32).get_data(data.size())[1], data)
+	# Overlapping copy within memory
+	expect_eq(wasm_b.memory.copy_from(wasm_b.memory, 32, 34, 4), OK)
+	expect_eq(wasm_b.memory.seek(32).get_data(8)[1], PackedByteArray([1, 2, 1, 2, 3, 4, 7, 8]))
+	expect_eq(wasm_b.memory.fill(0xAA, 32, 2), OK)
+	expect_eq(wasm_b.function("load_byte", [33]), 0xAA)
+	expect_eq(wasm_b.memory.copy_from(wasm_a.memory, PAGE_SIZE - 4, 0, 8), ERR_PARAMETER_RANGE_ERROR)
+	expect_error("Memory region out of bounds")
+
+func test_memory_view():
+	var wasm = load_wasm("memory")
+	var view = wasm.memory.view(256, 16)
+	expect(view.is_view())
+	view.seek(0).put_u8(0x7F)
+	expect_eq(wasm.function("load_byte", [256]), 0x7F)
+	expect_eq(view.fill(0, 16, 1), ERR_PARAMETER_RANGE_ERROR)
+	expect_error("Memory region out of bounds")
+	# Views can not be imported by another instance
+	load_wasm("memory-import", { "memory": view }, ERR_CANT_CREATE)
+	expect_error("Memory view can not be imported")
@@ -0,0 +1,110 @@
+extends GodotWasmTestSuite
+
+# Request and result layouts of the godot.physics3D shims
+const RAY_REQUEST_SIZE = 32
+const RAY_HIT_SIZE = 40
+const SHAPE_CAST_REQUEST_SIZE = 80
+const SHAPE_CAST_RESULT_SIZE = 8
+const RAY_COLLIDE_WITH_BODIES = 1
+const RESULTS = 0x8000
+
+func test_intersect_rays():
+	var body = add_box()
+	var wasm = load_wasm("physics")
+	# One ray hitting the top of the box and one missing it
+	put_ray(wasm.memory, 0, Vector3(0, 5, 0), Vector3(0, -5, 0))
+	put_ray(wasm.memory, 1, Vector3(5, 5, 0), Vector3(5, -5, 0))
+	var count = wasm.function("intersect_rays", [body.get_instance_id(), 0, 2, RESULTS])
+	expect_eq(count, 1)
+	var hit = get_hit(wasm.memory, 0)
+	expect(hit.position.is_equal_approx(Vector3(0, 1, 0)))
+	expect(hit.normal.is_equal_approx(Vector3(0, 1, 0)))
+	expect_eq(hit.collider_id, body.get_instance_id())
+	expect_eq(hit.shape, 0)
+	expect_eq(hit.hit, 1)
+	expect_eq(get_hit(wasm.memory, 1), { "position": Vector3(), "normal": Vector3(), "collider_id": 0, "shape": 0, "hit": 0 })
+	body.free()
+
+func test_intersect_rays_batch():
+	var body = add_box()
+	var wasm = load_wasm("physics")
+	# Parameters reused across a larger batch of alternating hits and misses
+	var rays = 256
+	for i in rays: put_ray(wasm.memory, i, Vector3(0, 5, 0), Vector3(0, -5, 0) if i % 2 else Vector3(5, -5, 0))
+	var count = wasm.function("intersect_rays", [body.get_instance_id(), 0, rays, RESULTS])
+	expect_eq(count, rays / 2)
+	for i in rays: expect_eq(get_hit(wasm.memory, i).hit, i % 2)
+	body.free()
+
+func test_cast_shapes():
+	var body = add_box()
+	var wasm = load_wasm("physics")
+	var sphere = SphereShape3D.new()
+	sphere.radius = 0.5
+	# One sphere falling onto the box and one passing beside it
+	put_cast(wasm.memory, 0, sphere, Vector3(0, 5, 0), Vector3(0, -10, 0))
+	put_cast(wasm.memory, 1, sphere, Vector3(5, 5, 0), Vector3(0, -10, 0))
+	var count = wasm.function("cast_shapes", [body.get_instance_id(), 0, 2, RESULTS])
+	expect_eq(count, 1)
+	var safe = wasm.memory.seek(RESULTS).get_float()
+	var unsafe = wasm.memory.get_float()
+	expect(safe > 0.3 && safe < 0.4)
+	expect(unsafe >= safe && unsafe < 0.4)
+	expect_eq(wasm.memory.seek(RESULTS + SHAPE_CAST_RESULT_SIZE).get_float(), 1.0)
+	expect_eq(wasm.memory.get_float(), 1.0)
+	body.free()
+
+func test_physics_out_of_bounds():
+	var body = add_box()
+	var wasm = load_wasm("physics")
+	var count = wasm.function("intersect_rays", [body.get_instance_id(), PAGE_SIZE - RAY_REQUEST_SIZE, 2, RESULTS])
+	expect_eq(count, null)
+	expect_error("Failed calling function intersect_rays")
+	body.free()
+
+# Physics scene utils
+
+func add_box() -> StaticBody3D:
+	# Box of size 2 centred on the origin
+	var body = StaticBody3D.new()
+	var collision = CollisionShape3D.new()
+	collision.shape = BoxShape3D.new()
+	collision.shape.size = Vector3(2, 2, 2)
+	body.add_child(collision)
+	Engine.get_main_loop().root.add_child(body)
+	return body
+
+func put_vector3(memory: WasmMemory, v: Vector3):
+	memory.put_float(v.x)
+	memory.put_float(v.y)
+	memory.put_float(v.z)
+
+func get_vector3(memory: WasmMemory) -> Vector3:
+	return Vector3(memory.get_float(), memory.get_float(), memory.get_float())
+
+func put_ray(memory: WasmMemory, i: int, from: Vector3, to: Vector3):
+	memory.seek(i * RAY_REQUEST_SIZE)
+	put_vector3(memory, from)
+	put_vector3(memory, to)
+	memory.put_u32(0xFFFFFFFF) # Mask
+	memory.put_u32(RAY_COLLIDE_WITH_BODIES)
+
+func get_hit(memory: WasmMemory, i: int) -> Dictionary:
+	memory.seek(RESULTS + i * RAY_HIT_SIZE)
+	return {
+		"position": get_vector3(memory),
+		"normal": get_vector3(memory),
+		"collider_id": memory.get_u64(),
+		"shape": memory.get_32(),
+		"hit": memory.get_u32(),
+	}
+
+func put_cast(memory: WasmMemory, i: int, shape: Shape3D, origin: Vector3, motion: Vector3):
+	memory.seek(i * SHAPE_CAST_REQUEST_SIZE)
+	memory.put_u64(shape.get_instance_id())
+	for row in [Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1)]: put_vector3(memory, row) # Identity basis
+	put_vector3(memory, origin)
+	put_vector3(memory, motion)
+	memory.put_u32(0xFFFFFFFF) # Mask
+	memory.put_u32(RAY_COLLIDE_WITH_BODIES)
+	memory.put_float(0.04) # Margin
@@ -13,3 +13,46 @@ func test_multivalue_invoke():
 	var result = wasm.function("multi_return", [123, 456])
 	expect_type(result, TYPE_ARRAY)
 	expect_eq(result, [456, 123])
+
+func test_flattened_export():
+	var imports = {
+		"functions": { "env.transform": [self, "transform_vector"] },
+		"export_signatures": {
+			"swizzle": [[TYPE_VECTOR3], [TYPE_VECTOR3]],
+			"length_squared": [[TYPE_VECTOR3], [TYPE_FLOAT]],
+		},
+	}
+	var wasm = load_wasm("flatten", imports)
+	expect_eq(wasm.function("swizzle", [Vector3(1.0, 2.0, 3.0)]), Vector3(3.0, 2.0, 1.0))
+	expect_eq(wasm.function("length_squared", [Vector3(1.0, 2.0, 3.0)]), 14.0)
+	# Undeclared signatures remain scalar
+	expect_eq(wasm.function("call_transform", [1.0, 2.0, 3.0]), [2.0, 4.0, 6.0])
+	# Invalid argument type
+	expect_eq(wasm.function("swizzle", [Vector2(1.0, 2.0)]), null)
+	expect_error("Invalid value type Vector2")
+
+func test_flattened_import():
+	var imports = {
+		"functions": { "env.transform": [self, "transform_vector", [[TYPE_VECTOR3], [TYPE_VECTOR3]]] },
+		"export_signatures": { "call_transform": [[TYPE_FLOAT, TYPE_FLOAT, TYPE_FLOAT], [TYPE_VECTOR3]] },
+	}
+	var wasm = load_wasm("flatten", imports)
+	expect_eq(wasm.function("call_transform", [1.0, 2.0, 3.0]), Vector3(2.0, 4.0, 6.0))
+
+func test_flattened_signature_mismatch():
+	var wasm = Wasm.new()
+	var buffer = read_file("flatten")
+	var error = wasm.compile(buffer)
+	expect_eq(error, OK)
+	var imports = {
+		"functions": { "env.transform": [self, "transform_vector"] },
+		"export_signatures": { "swizzle": [[TYPE_VECTOR2], [TYPE_VECTOR3]] },
+	}
+	error = wasm.instantiate(imports)
+	expect_eq(error, ERR_CANT_CREATE)
+	expect_error("Signature mismatch")
+
+func transform_vector(a, b = null, c = null):
+	# Invoked with a Vector3 when declared or three floats otherwise
+	if a is Vector3: return a * 2.0
+	return [a * 2.0, b * 2.0, c * 2.0]
@@ -10,8 +10,30 @@ func test_compile():
 func test_fd_write():
 	var wasm = load_wasm("wasi")
 	wasm.function("fd_write", [])
+	wasm.flush_output() # Otherwise flushed at end of frame
 	expect_log("Test fd_write")
 
+func test_redirect_output():
+	var wasm = load_wasm("wasi")
+	var received = []
+	wasm.stdout_received.connect(func(text): received.append(text))
+	expect_eq(wasm.redirect_output(1, "signal"), OK)
+	wasm.function("fd_write", [])
+	wasm.function("fd_write", [])
+	wasm.flush_output()
+	expect_eq(received.size(), 1) # Batched
+	expect(received[0].contains("Test fd_write"))
+	expect_eq(wasm.redirect_output(1, "discard"), OK)
+	wasm.function("fd_write", [])
+	wasm.flush_output()
+	expect_empty()
+	expect_eq(wasm.redirect_output(1, "file", "user://stdout.txt"), OK)
+	wasm.function("fd_write", [])
+	wasm.flush_output()
+	expect(FileAccess.get_file_as_string("user://stdout.txt").contains("Test fd_write"))
+	expect_eq(wasm.redirect_output(3, "log"), ERR_INVALID_PARAMETER)
+	expect_error("Invalid output file descriptor")
+
 func test_proc_exit():
 	var wasm = load_wasm("wasi")
 	wasm.function("proc_exit", [0])
@@ -37,12 +59,66 @@ func test_random_get():
 	var result = wasm.function("random_get", [])
 	expect(abs(result) <= 0xFF)
 
+func test_random_seed():
+	var a = load_wasm("wasi")
+	var b = load_wasm("wasi")
+	a.seed_random(42)
+	b.seed_random(42)
+	expect(a.is_random_seeded())
+	for i in 8: expect_eq(a.function("random_get", []), b.function("random_get", []))
+	# Seeded sequence restarts on instantiation
+	a.instantiate({})
+	var c = Wasm.new()
+	c.seed_random(42)
+	c.load(read_file("wasi"), {})
+	for i in 8: expect_eq(a.function("random_get", []), c.function("random_get", []))
+	a.unseed_random()
+	expect_eq(a.is_random_seeded(), false)
+
 func test_clock_time_get():
 	var time = Time.get_unix_time_from_system() * 1000
 	var wasm = load_wasm("wasi")
 	var result = wasm.function("clock_time_get", [])
 	expect_within(result, time, 1000.0) # Within one second
 
+func test_deterministic():
+	var a = load_wasm("wasi")
+	var b = load_wasm("wasi")
+	if !WasmEngineConfig.is_supported("determinism/nan_canonicalization"):
+		a.deterministic = true
+		expect_error("NaN canonicalization unsupported by runtime")
+		skip("Deterministic mode unsupported by runtime")
+		return
+	for wasm in [a, b]:
+		wasm.deterministic = true
+		wasm.virtual_clock = 5000000000
+		expect(wasm.is_random_seeded())
+		expect_eq(wasm.function("clock_time_get", []), 5000) # Milliseconds
+		wasm.function("random_get", [])
+	expect_eq(a.get_state_hash(), b.get_state_hash())
+	# Desync detected
+	var byte = a.memory.seek(0).get_u8()
+	a.memory.seek(0).put_u8(byte ^ 1)
+	expect_ne(a.get_state_hash(), b.get_state_hash())
+	expect_empty()
+
+func test_deterministic_nan():
+	var wasm = load_wasm("nan")
+	if !WasmEngineConfig.is_supported("determinism/nan_canonicalization"):
+		# Deterministic mode refused rather than enabled without canonicalization
+		wasm.deterministic = true
+		expect_error("NaN canonicalization unsupported by runtime")
+		expect_eq(wasm.deterministic, false)
+		return
+	# Canonicalization enabled by test runner where supported
+	expect_eq(WasmEngineConfig.get_setting("determinism/nan_canonicalization"), true)
+	wasm.deterministic = true
+	expect_eq(wasm.deterministic, true)
+	# Payload otherwise propagated subject to host hardware
+	expect_eq(wasm.function("add_nan32", [0x7fa00001]), 0x7fc00000)
+	expect_eq(wasm.function("add_nan64", [0x7ff4000000000001]), 0x7ff8000000000000)
+	expect_empty()
+
 func test_permissions():
 	var wasm = load_wasm("wasi")
 	expect_includes(wasm.permissions, "print")
@@ -68,3 +144,32 @@ func test_invalid_permissions():
 	wasm.permissions = { "random": true, "time": false }
 	wasm.function("clock_time_get", [])
 	expect_error("Failed calling function clock_time_get")
+
+func test_thread_spawn():
+	# Threads are unsupported so wasi-threads import is not provided
+	load_wasm("thread-spawn", {}, ERR_CANT_CREATE)
+	expect_error("Missing import function wasi.thread-spawn")
+
+func test_filesystem():
+	var wasm = load_wasm("filesystem", { "preopens": { "/data": "res://wasm" } })
+	expect_eq(wasm.function("read_file", []), -2) # Not permitted by default
+	wasm.permissions = { "filesystem": true }
+	expect_eq(wasm.function("read_file", []), 0x6d736100) # Magic number
+	expect_eq(wasm.function("file_size", []), read_file("simple").size())
+	expect_eq(wasm.function("open_escape", []), -76)
+	expect_eq(wasm.function("open_missing", []), -44)
+	expect_empty()
+
+func test_filesystem_reinstantiate():
+	# Preopens of previous instance are not duplicated
+	var wasm = load_wasm("filesystem", { "preopens": { "/data": "res://wasm" } })
+	expect_eq(wasm.instantiate({ "preopens": { "/data": "res://wasm" } }), OK)
+	wasm.permissions = { "filesystem": true }
+	expect_eq(wasm.function("prestat", [3]), 0)
+	expect_eq(wasm.function("prestat", [4]), 8) # Bad file descriptor ends enumeration
+	expect_empty()
+
+func test_invalid_preopen():
+	load_wasm("filesystem", { "preopens": { "/data": "res://missing" } }, ERR_CANT_CREATE)
+	expect_error("Invalid preopen directory res://missing")
+	expect_error("Invalid preopen /data")
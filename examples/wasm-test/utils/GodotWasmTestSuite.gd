@@ -3,6 +3,7 @@ class_name GodotWasmTestSuite
 
 const PAGE_SIZE: int = 0b1 << 16
 const PAGES_MAX: int = PAGE_SIZE * (PAGE_SIZE - 1)
+const TABLE_MAX: int = 0xFFFFFFFF # Limit reported for tables without declared maximum
 
 # Test suite overrides
 
@@ -10,6 +10,10 @@ enum LogDestination { All, UI }
 func _ready():
 	record("Log dir: %s" % OS.get_user_data_dir())
 
+	# Engine settings lock once the first module is compiled; only enable those supported by the runtime
+	if WasmEngineConfig.is_supported("determinism/nan_canonicalization"):
+		WasmEngineConfig.set_setting("determinism/nan_canonicalization", true)
+
 	var results = Results.new()
 
 	var regex = Utils.make_regex("^Test\\w+\\.gd")
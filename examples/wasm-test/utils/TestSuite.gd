@@ -24,6 +24,10 @@ func run(f):
 
 # Test condition utils
 
+func skip(reason: String):
+	# Explicitly mark remainder of test case as unsupported by the current runtime
+	print("Skipping test case: %s" % reason)
+
 func expect_log(s: String):
 	if !OS.has_feature("editor"): # Log file is not live when exported
 		print("Export build skipping expect log: %s" % s)
@@ -97,13 +97,15 @@ func _localize_aspect_fit(p: Vector2, outer: Vector2, inner: Vector2):
 func _abort(a: int, b: int, c: int, d: int) -> void: # Throw error from Wasm module
 	push_error("Abort from Wasm module: %d %d %d %d" % [a, b, c, d])
 
-func _draw_image(p: int, s: int) -> void: # Draw the entire image from Wasm memory
-	image.set_data(int(size.x), int(size.y), false, Image.FORMAT_RGBA8, wasm.memory.seek(p).get_data(s)[1])
-	texture.update(image)
+func _draw_image(p: int, _s: int) -> void: # Stream the entire image from Wasm memory
+	wasm.framebuffer.bind(wasm.memory, p, int(size.x), int(size.y))
+	wasm.framebuffer.mark_dirty(Rect2i(Vector2i.ZERO, Vector2i(size)))
+	$TextureRect.texture = wasm.framebuffer.texture
 
 func _draw_pixel(x: int, y: int, r: int, g: int, b: int, a: int) -> void: # Draw a single pixel with color component values
 	image.set_pixel(x, y, Color8(r, g, b, a))
 	texture.update(image)
+	$TextureRect.texture = texture
 
 func _seed() -> float: # Provide a random seed to the Wasm module
 	return randf()
@@ -1,22 +1,61 @@
 #include "register_types.h"
 #include "src/godot-wasm.h"
 #include "src/wasm-memory.h"
+#include "src/wasm-framebuffer.h"
+#include "src/audio-stream-wasm.h"
+#include "src/wasm-module.h"
+#include "src/wasm-engine-config.h"
+#include "src/wasm-export-plugin.h"
 
 using namespace godot;
 
+static Ref<ResourceFormatLoaderWasm> resource_loader_wasm;
+
 void initialize_wasm_module(ModuleInitializationLevel p_level) {
+  #ifdef WASM_EDITOR_ENABLED
+    if (p_level == MODULE_INITIALIZATION_LEVEL_EDITOR) {
+      ClassDB::register_class<WasmExportPlugin>();
+      ClassDB::register_class<WasmEditorPlugin>();
+      EditorPlugins::add_by_type<WasmEditorPlugin>();
+      return;
+    }
+  #endif
+
   if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
     return;
   }
 
+  // Engine is created on first use so project settings apply to all instances
+  ClassDB::register_class<WasmEngineConfig>();
+  WasmEngineConfig::load_project_settings();
+
   ClassDB::register_class<Wasm>();
   ClassDB::register_class<WasmMemory>();
+  ClassDB::register_class<WasmFramebuffer>();
+  ClassDB::register_class<WasmModule>();
+  ClassDB::register_class<ResourceFormatLoaderWasm>();
+  ClassDB::register_class<AudioStreamWasm>();
+  ClassDB::register_class<AudioStreamPlaybackWasm>();
+
+  resource_loader_wasm.instantiate();
+  #ifdef GODOT_MODULE
+    ResourceLoader::add_resource_format_loader(resource_loader_wasm);
+  #else
+    ResourceLoader::get_singleton()->add_resource_format_loader(resource_loader_wasm);
+  #endif
 }
 
 void uninitialize_wasm_module(ModuleInitializationLevel p_level) {
   if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
     return;
   }
+
+  #ifdef GODOT_MODULE
+    ResourceLoader::remove_resource_format_loader(resource_loader_wasm);
+  #else
+    ResourceLoader::get_singleton()->remove_resource_format_loader(resource_loader_wasm);
+  #endif
+  resource_loader_wasm.unref();
 }
 
 #ifndef GODOT_MODULE
@@ -0,0 +1,203 @@
+#include "wasm.h"
+#include "audio-stream-wasm.h"
+
+namespace godot {
+  static_assert(sizeof(AudioFrame) == 2 * sizeof(float), "Guest frames must match AudioFrame layout");
+
+  void AudioStreamWasm::REGISTRATION_METHOD() {
+    ClassDB::bind_method(D_METHOD("set_bytecode", "bytecode"), &AudioStreamWasm::set_bytecode);
+    ClassDB::bind_method(D_METHOD("get_bytecode"), &AudioStreamWasm::get_bytecode);
+    ClassDB::bind_method(D_METHOD("set_process_function", "name"), &AudioStreamWasm::set_process_function);
+    ClassDB::bind_method(D_METHOD("get_process_function"), &AudioStreamWasm::get_process_function);
+    ClassDB::bind_method(D_METHOD("set_buffer_global", "name"), &AudioStreamWasm::set_buffer_global);
+    ClassDB::bind_method(D_METHOD("get_buffer_global"), &AudioStreamWasm::get_buffer_global);
+    ClassDB::bind_method(D_METHOD("set_buffer_frames", "frames"), &AudioStreamWasm::set_buffer_frames);
+    ClassDB::bind_method(D_METHOD("get_buffer_frames"), &AudioStreamWasm::get_buffer_frames);
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "bytecode"), "set_bytecode", "get_bytecode");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "process_function"), "set_process_function", "get_process_function");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "buffer_global"), "set_buffer_global", "get_buffer_global");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "buffer_frames"), "set_buffer_frames", "get_buffer_frames");
+  }
+
+  AudioStreamWasm::AudioStreamWasm() {
+    process_function = "process";
+    buffer_global = "frames";
+    buffer_frames = 512;
+  }
+
+  AudioStreamWasm::~AudioStreamWasm() { }
+
+  void AudioStreamWasm::set_bytecode(const PackedByteArray &bytecode) {
+    this->bytecode = bytecode;
+  }
+
+  PackedByteArray AudioStreamWasm::get_bytecode() const {
+    return bytecode;
+  }
+
+  void AudioStreamWasm::set_process_function(const String &name) {
+    process_function = name;
+  }
+
+  String AudioStreamWasm::get_process_function() const {
+    return process_function;
+  }
+
+  void AudioStreamWasm::set_buffer_global(const String &name) {
+    buffer_global = name;
+  }
+
+  String AudioStreamWasm::get_buffer_global() const {
+    return buffer_global;
+  }
+
+  void AudioStreamWasm::set_buffer_frames(int32_t frames) {
+    FAIL_IF(frames <= 0, "Invalid buffer frames", );
+    buffer_frames = frames;
+  }
+
+  int32_t AudioStreamWasm::get_buffer_frames() const {
+    return buffer_frames;
+  }
+
+  Ref<AudioStreamPlayback> AudioStreamWasm::INTERFACE_INSTANTIATE_PLAYBACK {
+    Ref<AudioStreamPlaybackWasm> playback;
+    INSTANTIATE_REF(playback);
+    playback->set_stream(Ref<AudioStreamWasm>(const_cast<AudioStreamWasm*>(this)));
+    return playback;
+  }
+
+  String AudioStreamWasm::INTERFACE_GET_STREAM_NAME {
+    return "Wasm";
+  }
+
+  double AudioStreamWasm::INTERFACE_GET_LENGTH {
+    return 0; // Generated; no fixed length
+  }
+
+  void AudioStreamPlaybackWasm::REGISTRATION_METHOD() {
+    ClassDB::bind_method(D_METHOD("start", "from_pos"), &AudioStreamPlaybackWasm::INTERFACE_METHOD(start), DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("stop"), &AudioStreamPlaybackWasm::INTERFACE_METHOD(stop));
+    ClassDB::bind_method(D_METHOD("is_playing"), &AudioStreamPlaybackWasm::INTERFACE_METHOD(is_playing));
+    ClassDB::bind_method(D_METHOD("mix_frames", "frames"), &AudioStreamPlaybackWasm::mix_frames);
+  }
+
+  AudioStreamPlaybackWasm::AudioStreamPlaybackWasm() {
+    process = NULL;
+    buffer_offset = 0;
+    buffer_frames = 0;
+    active = false;
+    mixed = 0;
+  }
+
+  AudioStreamPlaybackWasm::~AudioStreamPlaybackWasm() {
+    std::lock_guard<std::mutex> lock(mutex);
+    active = false;
+    process = NULL;
+    wasm = Ref<Wasm>();
+  }
+
+  void AudioStreamPlaybackWasm::set_stream(const Ref<AudioStreamWasm> &stream) {
+    this->stream = stream;
+  }
+
+  void AudioStreamPlaybackWasm::silence(AudioFrame* buffer, int32_t frames) const {
+    memset(buffer, 0, sizeof(AudioFrame) * frames);
+  }
+
+  void AudioStreamPlaybackWasm::INTERFACE_START {
+    std::lock_guard<std::mutex> lock(mutex);
+    active = false;
+    mixed = 0;
+    if (wasm.is_valid()) { // Resume existing instance
+      active = true;
+      return;
+    }
+    FAIL_IF(stream.is_null(), "Invalid audio stream", );
+
+    // Instantiate module in its own store as it is invoked from the audio thread
+    Ref<Wasm> instance;
+    INSTANTIATE_REF(instance);
+    instance->isolate();
+    FAIL_IF(instance->load(stream->get_bytecode(), Dictionary()) != OK, "Failed to load audio stream module", );
+    FAIL_IF(instance->get_memory().is_null(), "Audio stream module has no memory", );
+    const wasm_func_t* func = instance->get_export_function(stream->get_process_function());
+    FAIL_IF(func == NULL, "Missing audio process function " + stream->get_process_function(), );
+    FAIL_IF(wasm_func_param_arity(func) != 2 || wasm_func_result_arity(func) != 0, "Invalid audio process function signature", );
+    Variant offset = instance->global(stream->get_buffer_global());
+    FAIL_IF(offset.get_type() != Variant::INT, "Invalid audio buffer global " + stream->get_buffer_global(), );
+
+    wasm = instance;
+    process = func;
+    buffer_offset = (uint32_t)(int64_t)offset;
+    buffer_frames = stream->get_buffer_frames();
+    active = true;
+  }
+
+  void AudioStreamPlaybackWasm::INTERFACE_STOP {
+    active = false;
+  }
+
+  bool AudioStreamPlaybackWasm::INTERFACE_IS_PLAYING {
+    return active;
+  }
+
+  int32_t AudioStreamPlaybackWasm::INTERFACE_GET_LOOP_COUNT {
+    return 0;
+  }
+
+  double AudioStreamPlaybackWasm::INTERFACE_GET_PLAYBACK_POSITION {
+    return (double)mixed / AudioServer::get_singleton()->get_mix_rate();
+  }
+
+  void AudioStreamPlaybackWasm::INTERFACE_SEEK { } // Generated; not seekable
+
+  int32_t AudioStreamPlaybackWasm::INTERFACE_MIX {
+    // Invoked on the audio thread; avoid blocking and Variant conversion
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !active) {
+      silence(buffer, frames);
+      return frames;
+    }
+    wasm_memory_t* memory = wasm->get_memory()->get_memory();
+    wasm_val_t args_data[2];
+    args_data[0].kind = WASM_I32;
+    args_data[0].of.i32 = (int32_t)buffer_offset;
+    args_data[1].kind = WASM_I32;
+    wasm_val_vec_t args = { 2, args_data };
+    wasm_val_vec_t results = { 0, NULL };
+    for (int32_t mixed_frames = 0; mixed_frames < frames;) {
+      int32_t count = MIN(frames - mixed_frames, buffer_frames);
+      args_data[1].of.i32 = count;
+      wasm_trap_t* trap = wasm_func_call(process, &args, &results);
+      size_t length = sizeof(AudioFrame) * count;
+      if (trap != NULL || buffer_offset + length > wasm_memory_data_size(memory)) {
+        if (trap != NULL) wasm_trap_delete(trap);
+        active = false;
+        silence(buffer + mixed_frames, frames - mixed_frames);
+        PRINT_ERROR("Audio stream process failed");
+        break;
+      }
+      memcpy(buffer + mixed_frames, wasm_memory_data(memory) + buffer_offset, length); // Data pointer may move on growth
+      mixed_frames += count;
+    }
+    mixed += frames;
+    return frames;
+  }
+
+  PackedVector2Array AudioStreamPlaybackWasm::mix_frames(int32_t frames) {
+    // Mixes on the calling thread e.g. for offline rendering
+    PackedVector2Array result;
+    FAIL_IF(frames < 0, "Invalid frame count", result);
+    std::vector<AudioFrame> buffer(frames);
+    #ifdef GODOT_MODULE
+      mix(buffer.data(), 1.0, frames);
+    #else
+      _mix(buffer.data(), 1.0, frames);
+    #endif
+    result.resize(frames);
+    const float* samples = (const float*)buffer.data();
+    for (int32_t i = 0; i < frames; i++) result.set(i, Vector2(samples[i * 2], samples[i * 2 + 1]));
+    return result;
+  }
+}
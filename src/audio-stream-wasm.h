@@ -0,0 +1,93 @@
+#ifndef AUDIO_STREAM_WASM_H
+#define AUDIO_STREAM_WASM_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "defs.h"
+#include "godot-wasm.h"
+
+#ifdef GODOT_MODULE
+  #define INTERFACE_INSTANTIATE_PLAYBACK instantiate_playback()
+  #define INTERFACE_GET_STREAM_NAME get_stream_name() const
+  #define INTERFACE_GET_LENGTH get_length() const
+  #define INTERFACE_START start(double from_pos)
+  #define INTERFACE_STOP stop()
+  #define INTERFACE_IS_PLAYING is_playing() const
+  #define INTERFACE_GET_LOOP_COUNT get_loop_count() const
+  #define INTERFACE_GET_PLAYBACK_POSITION get_playback_position() const
+  #define INTERFACE_SEEK seek(double position)
+  #define INTERFACE_MIX mix(AudioFrame* buffer, float rate_scale, int32_t frames)
+  #define INTERFACE_METHOD(name) name
+#else
+  #define INTERFACE_INSTANTIATE_PLAYBACK _instantiate_playback() const
+  #define INTERFACE_GET_STREAM_NAME _get_stream_name() const
+  #define INTERFACE_GET_LENGTH _get_length() const
+  #define INTERFACE_START _start(double from_pos)
+  #define INTERFACE_STOP _stop()
+  #define INTERFACE_IS_PLAYING _is_playing() const
+  #define INTERFACE_GET_LOOP_COUNT _get_loop_count() const
+  #define INTERFACE_GET_PLAYBACK_POSITION _get_playback_position() const
+  #define INTERFACE_SEEK _seek(double position)
+  #define INTERFACE_MIX _mix(AudioFrame* buffer, double rate_scale, int32_t frames)
+  #define INTERFACE_METHOD(name) _##name
+#endif
+
+namespace godot {
+  class AudioStreamWasm : public AudioStream {
+    GDCLASS(AudioStreamWasm, AudioStream);
+
+    private:
+      PackedByteArray bytecode;
+      String process_function; // Export invoked as process(frames_ptr, count)
+      String buffer_global; // Exported global holding offset of guest frame buffer
+      int32_t buffer_frames; // Capacity of guest frame buffer
+
+    public:
+      static void REGISTRATION_METHOD();
+      AudioStreamWasm();
+      ~AudioStreamWasm();
+      void set_bytecode(const PackedByteArray &bytecode);
+      PackedByteArray get_bytecode() const;
+      void set_process_function(const String &name);
+      String get_process_function() const;
+      void set_buffer_global(const String &name);
+      String get_buffer_global() const;
+      void set_buffer_frames(int32_t frames);
+      int32_t get_buffer_frames() const;
+      Ref<AudioStreamPlayback> INTERFACE_INSTANTIATE_PLAYBACK override;
+      String INTERFACE_GET_STREAM_NAME override;
+      double INTERFACE_GET_LENGTH override;
+  };
+
+  class AudioStreamPlaybackWasm : public AudioStreamPlayback {
+    GDCLASS(AudioStreamPlaybackWasm, AudioStreamPlayback);
+
+    private:
+      Ref<AudioStreamWasm> stream;
+      Ref<Wasm> wasm; // Isolated instance owned by this playback
+      const wasm_func_t* process; // Borrowed from instance exports
+      uint32_t buffer_offset;
+      int32_t buffer_frames;
+      std::mutex mutex; // Guards instance against concurrent start/stop and mix
+      std::atomic<bool> active;
+      std::atomic<uint64_t> mixed; // Frames mixed since start
+      void silence(AudioFrame* buffer, int32_t frames) const;
+
+    public:
+      static void REGISTRATION_METHOD();
+      AudioStreamPlaybackWasm();
+      ~AudioStreamPlaybackWasm();
+      void set_stream(const Ref<AudioStreamWasm> &stream);
+      void INTERFACE_START override;
+      void INTERFACE_STOP override;
+      bool INTERFACE_IS_PLAYING override;
+      int32_t INTERFACE_GET_LOOP_COUNT override;
+      double INTERFACE_GET_PLAYBACK_POSITION override;
+      void INTERFACE_SEEK override;
+      int32_t INTERFACE_MIX override;
+      PackedVector2Array mix_frames(int32_t frames);
+  };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "decompress.h"
+
+#define GZIP_MAGIC 0x8b1f
+#define ZSTD_MAGIC 0xfd2fb528
+#define DECOMPRESSED_SIZE_MAX 0x7fffffff // Godot compression API sizes are signed 32-bit
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      enum Format { FORMAT_NONE, FORMAT_GZIP, FORMAT_ZSTD };
+
+      uint64_t read_le(const uint8_t* data, uint8_t bytes) {
+        uint64_t value = 0;
+        for (uint8_t i = 0; i < bytes; i++) value |= (uint64_t)data[i] << (8 * i);
+        return value;
+      }
+
+      Format detect(const uint8_t* data, size_t size) {
+        if (size >= 18 && read_le(data, 2) == GZIP_MAGIC) return FORMAT_GZIP;
+        if (size >= 6 && read_le(data, 4) == ZSTD_MAGIC) return FORMAT_ZSTD;
+        return FORMAT_NONE;
+      }
+
+      uint64_t gzip_size(const uint8_t* data, size_t size) {
+        // ISIZE trailer holds decompressed size modulo 2^32
+        return read_le(data + size - 4, 4);
+      }
+
+      uint64_t zstd_size(const uint8_t* data, size_t size) {
+        // Frame_Content_Size from frame header; zero if absent
+        // https://github.com/facebook/zstd/blob/dev/doc/zstd_compression_format.md#frame_header
+        const uint8_t descriptor = data[4];
+        const uint8_t fcs_flag = descriptor >> 6;
+        const bool single_segment = descriptor & 0x20;
+        const uint8_t did_sizes[] = { 0, 1, 2, 4 };
+        const uint8_t fcs_sizes[] = { (uint8_t)(single_segment ? 1 : 0), 2, 4, 8 };
+        const size_t offset = 5 + (single_segment ? 0 : 1) + did_sizes[descriptor & 0x03];
+        const uint8_t fcs_size = fcs_sizes[fcs_flag];
+        if (fcs_size == 0 || offset + fcs_size > size) return 0;
+        const uint64_t value = read_le(data + offset, fcs_size);
+        return fcs_size == 2 ? value + 256 : value;
+      }
+    }
+
+    bool is_compressed(const uint8_t* data, size_t size) {
+      return detect(data, size) != FORMAT_NONE;
+    }
+
+    godot_error decompress(const uint8_t* data, size_t size, PackedByteArray &out) {
+      // Output size is read from format headers so decompression requires a single allocation
+      const Format format = detect(data, size);
+      FAIL_IF(format == FORMAT_NONE, "Unrecognized compression format", ERR_INVALID_DATA);
+      FAIL_IF(size > DECOMPRESSED_SIZE_MAX, "Compressed module too large", ERR_OUT_OF_MEMORY);
+      const uint64_t length = format == FORMAT_GZIP ? gzip_size(data, size) : zstd_size(data, size);
+      FAIL_IF(length == 0, "Unknown decompressed module size", ERR_INVALID_DATA);
+      FAIL_IF(length > DECOMPRESSED_SIZE_MAX, "Decompressed module too large", ERR_OUT_OF_MEMORY);
+      #ifdef GODOT_MODULE
+        // Decompress straight into destination buffer
+        out.resize(length);
+        const Compression::Mode mode = format == FORMAT_GZIP ? Compression::MODE_GZIP : Compression::MODE_ZSTD;
+        const int written = Compression::decompress(out.ptrw(), length, data, size, mode);
+      #else
+        // Extension API only exposes decompression of a packed array
+        PackedByteArray compressed;
+        compressed.resize(size);
+        memcpy(compressed.ptrw(), data, size);
+        const FileAccess::CompressionMode mode = format == FORMAT_GZIP ? FileAccess::COMPRESSION_GZIP : FileAccess::COMPRESSION_ZSTD;
+        out = compressed.decompress(length, mode);
+        const int64_t written = out.size();
+      #endif
+      FAIL_IF((uint64_t)written != length, "Decompression failed", ERR_INVALID_DATA);
+      return OK;
+    }
+  }
+}
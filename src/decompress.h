@@ -0,0 +1,14 @@
+#ifndef GODOT_WASM_DECOMPRESS_H
+#define GODOT_WASM_DECOMPRESS_H
+
+#include "defs.h"
+
+namespace godot {
+  namespace godot_wasm {
+    // Modules compressed with gzip or zstd are detected by magic bytes and decompressed before compilation
+    bool is_compressed(const uint8_t* data, size_t size);
+    godot_error decompress(const uint8_t* data, size_t size, PackedByteArray &out);
+  }
+}
+
+#endif
@@ -4,29 +4,53 @@
 #ifdef GODOT_MODULE // Godot includes when building module
   #include "core/os/os.h"
   #include "core/os/time.h"
-  #include "core/crypto/crypto.h"
+  #include "core/crypto/crypto_core.h"
   #include "core/io/stream_peer.h"
+  #include "core/io/file_access.h"
+  #include "core/io/dir_access.h"
+  #include "core/io/compression.h"
+  #include "core/config/project_settings.h"
+  #include "core/io/resource_loader.h"
+  #include "core/io/image.h"
+  #include "scene/resources/image_texture.h"
+  #include "servers/audio/audio_stream.h"
+  #include "servers/audio_server.h"
+  #include "main/performance.h"
 #else // Godot addon includes
   #include "godot_cpp/classes/ref_counted.hpp"
   #include "godot_cpp/classes/os.hpp"
   #include "godot_cpp/classes/time.hpp"
   #include "godot_cpp/classes/crypto.hpp"
   #include "godot_cpp/classes/stream_peer_extension.hpp"
+  #include "godot_cpp/classes/file_access.hpp"
+  #include "godot_cpp/classes/dir_access.hpp"
+  #include "godot_cpp/classes/project_settings.hpp"
+  #include "godot_cpp/classes/resource_format_loader.hpp"
+  #include "godot_cpp/classes/resource_loader.hpp"
+  #include "godot_cpp/classes/image.hpp"
+  #include "godot_cpp/classes/image_texture.hpp"
+  #include "godot_cpp/classes/audio_stream.hpp"
+  #include "godot_cpp/classes/audio_stream_playback.hpp"
+  #include "godot_cpp/classes/audio_server.hpp"
+  #include "godot_cpp/classes/audio_frame.hpp"
+  #include "godot_cpp/classes/performance.hpp"
   #include "godot_cpp/variant/utility_functions.hpp"
 #endif
 
+#include <chrono>
+
 #ifdef GODOT_MODULE
   #define godot_error Error
   #define PRINT(message) print_line(String(message))
   #define PRINT_ERROR(message) print_error("Godot Wasm: " + String(message))
   #define REGISTRATION_METHOD _bind_methods
-  #define RANDOM_BYTES(n) Crypto::create()->generate_random_bytes(n)
+  #define FILE_EXISTS(path) FileAccess::exists(path)
 #else
   #define PRINT(message) UtilityFunctions::print(String(message))
   #define PRINT_ERROR(message) _err_print_error(__FUNCTION__, __FILE__, __LINE__, "Godot Wasm: " + String(message))
   #define godot_error Error
   #define REGISTRATION_METHOD _bind_methods
-  #define RANDOM_BYTES(n) [n]()->PackedByteArray{Ref<Crypto> c;c.instantiate();return c->generate_random_bytes(n);}()
+  #define FILE_EXISTS(path) FileAccess::file_exists(path)
 #endif
 #define FAIL(message, ret) do { PRINT_ERROR(message); return ret; } while (0)
 #define FAIL_IF(cond, message, ret) if (unlikely(cond)) FAIL(message, ret)
@@ -35,6 +59,7 @@
 #define CMDLINE_ARGS OS::get_singleton()->get_cmdline_user_args()
 #define TIME_REALTIME Time::get_singleton()->get_unix_time_from_system() * 1000000000
 #define TIME_MONOTONIC Time::get_singleton()->get_ticks_usec() * 1000
+#define TIME_PRECISE std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() // Nanosecond resolution unlike TIME_MONOTONIC
 #define NULL_VARIANT Variant()
 #define PAGE_SIZE 65536
 
@@ -1,9 +1,23 @@
 #include <string>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
 #include "godot-wasm.h"
 #include "wasi-shim.h"
+#include "wasi-filesystem.h"
+#include "wasi-random.h"
 #include "defer.h"
 #include "store.h"
+#include "marshal.h"
+#include "wasm-profiler.h"
+#include "wasm-sections.h"
+#include "wasm-tracer.h"
+#include "mapped-file.h"
+#include "decompress.h"
+#include "wasm-engine-config.h"
+
+#define SCRATCH_SIZE_MIN 65536 // Minimum scratch memory reserved via module allocator
 
 namespace godot {
   namespace godot_wasm {
@@ -12,21 +26,108 @@ namespace godot {
       context_extern(uint16_t i) { index = i; }
     };
 
+    struct context_stats {
+      uint64_t calls; // Number of calls
+      uint64_t total; // Cumulative duration in nanoseconds
+      uint64_t max; // Longest duration in nanoseconds
+      context_stats(): calls(0), total(0), max(0) { }
+      void record(uint64_t duration) {
+        calls++;
+        total += duration;
+        if (duration > max) max = duration;
+      }
+      Dictionary to_dictionary() const {
+        Dictionary dict;
+        dict["calls"] = calls;
+        dict["total_usec"] = total / 1000;
+        dict["max_usec"] = max / 1000;
+        dict["total_nsec"] = total;
+        dict["max_nsec"] = max;
+        return dict;
+      }
+    };
+
+    struct context_instrumentation {
+      bool stats; // Record call statistics
+      Profiler* profiler; // Active profiler if any
+      std::vector<Profiler*> stopped; // Stopped within a call; deleted once outermost call returns as frames still reference them
+      WasmMemory* memory; // Instance memory checked for growth at host boundaries
+      context_instrumentation(): stats(false), profiler(NULL), memory(NULL) { }
+      ~context_instrumentation() {
+        delete profiler;
+        release_stopped();
+      }
+      void release_stopped() {
+        for (auto profiler: stopped) delete profiler;
+        stopped.clear();
+      }
+    };
+
+    struct context_signature {
+      std::vector<Variant::Type> params; // Declared parameter types; empty if scalar
+      std::vector<Variant::Type> results; // Declared result types; empty if scalar
+    };
+
     struct context_func_import: public context_extern {
       Object* target; // The object from which to invoke callback method
       String method; // External name; doesn't necessarily match import name
-      context_func_import(uint16_t i): context_extern(i) { }
+      String name; // Import name in the form module.name
+      const char* trace_name; // Interned name
+      std::vector<wasm_valkind_t> results; // Result kinds used to encode return values
+      context_signature signature; // Math types flattened to consecutive scalars
+      context_stats stats; // Recorded only if enabled by instance
+      const context_instrumentation* instrumentation; // Owned by instance
+      context_func_import(uint16_t i, String name, std::vector<wasm_valkind_t> results): context_extern(i), name(name), trace_name(Tracer::intern(name)), results(results), instrumentation(NULL) { }
     };
 
     struct context_func_export: public context_extern {
       size_t return_count; // Number of return values
-      context_func_export(uint16_t i, size_t return_count): context_extern(i), return_count(return_count) { }
+      std::vector<wasm_valkind_t> params; // Parameter kinds used to encode arguments
+      context_signature signature; // Math types flattened to consecutive scalars
+      context_stats stats; // Recorded only if enabled by instance
+      const char* trace_name; // Interned name
+      context_func_export(uint16_t i, const String &name, size_t return_count, std::vector<wasm_valkind_t> params): context_extern(i), return_count(return_count), params(params), trace_name(Tracer::intern(name)) { }
+    };
+
+    struct context_table: public context_extern {
+      std::map<std::string, context_func_export> signatures; // Contexts of referenced functions keyed by encoded function type
+      context_table(uint16_t i): context_extern(i) { }
     };
 
     struct context_memory: public context_extern {
       bool import; // Import; not export
       context_memory(uint16_t i, bool import): context_extern(i), import(import) { }
     };
+
+    struct context_scratch {
+      uint32_t offset; // Start of scratch memory within module memory
+      uint32_t capacity; // Bytes reserved
+      uint32_t used; // Bytes used by in-flight calls
+      bool host; // Reserved by host rather than module allocator
+      context_scratch(): offset(0), capacity(0), used(0), host(false) { }
+    };
+
+    struct context_output {
+      enum Sink { SINK_LOG, SINK_SIGNAL, SINK_FILE, SINK_DISCARD };
+      std::mutex mutex; // Output may be written by isolated instances on other threads
+      std::string pending; // Written since last flush; may end with a partial line
+      Sink sink;
+      Ref<FileAccess> file;
+      context_output(): sink(SINK_LOG) { }
+    };
+
+    struct context_tier {
+      wasm_store_t* store; // Store of the default engine; restored once the optimized module replaces the baseline
+      std::thread thread; // Compiles optimized module
+      std::atomic<bool> ready;
+      wasm_module_t* optimized; // Written by worker before ready is set
+      Dictionary import_map; // Imports of baseline instance reused by optimized instance
+      context_tier(wasm_store_t* store): store(store), ready(false), optimized(NULL) { }
+      ~context_tier() {
+        if (thread.joinable()) thread.join();
+        if (optimized != NULL) wasm_module_delete(optimized);
+      }
+    };
   }
 
   namespace {
@@ -42,6 +143,20 @@ namespace godot {
       p = NULL;
     }
 
+    uint64_t hash_bytes(const uint8_t* data, size_t length, uint64_t hash) {
+      // Word-wise FNV-1a with folding for fast desync detection; not collision resistant
+      const uint64_t prime = 0x100000001b3;
+      size_t i = 0;
+      for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(uint64_t));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 32;
+      }
+      for (; i < length; i++) hash = (hash ^ data[i]) * prime;
+      return hash ^ length;
+    }
+
     Variant decode_variant(wasm_val_t value) {
       switch (value.kind) {
         case WASM_I32: return Variant(value.of.i32);
@@ -71,6 +186,25 @@ namespace godot {
       return value;
     }
 
+    wasm_val_t encode_variant(Variant variant, wasm_valkind_t kind) {
+      // Encode numeric variants as the kind expected by the function signature
+      if (variant.get_type() != Variant::INT && variant.get_type() != Variant::FLOAT && variant.get_type() != Variant::BOOL) return encode_variant(variant);
+      wasm_val_t value;
+      value.kind = kind;
+      switch (kind) {
+        case WASM_I32: value.of.i32 = (int32_t)(int64_t)variant; break;
+        case WASM_I64: value.of.i64 = (int64_t)variant; break;
+        case WASM_F32: value.of.f32 = (float32_t)(float64_t)variant; break;
+        case WASM_F64: value.of.f64 = (float64_t)variant; break;
+        default: return encode_variant(variant);
+      }
+      return value;
+    }
+
+    inline size_t align_marshalled(size_t size) {
+      return (size + MARSHAL_ALIGN - 1) & ~(size_t)(MARSHAL_ALIGN - 1);
+    }
+
     String decode_name(const wasm_name_t* name) {
       return String(std::string(name->data, name->size).c_str());
     }
@@ -83,22 +217,69 @@ namespace godot {
       return d.has(k) && d[k].get_type() == Variant::OBJECT ? Object::cast_to<T>(d[k]) : NULL;
     }
 
-    godot_error extract_results(Variant variant, wasm_val_vec_t* results) {
+    godot_error extract_results(Variant variant, wasm_val_vec_t* results, const std::vector<wasm_valkind_t>& kinds) {
       if (results->size <= 0) return OK;
       if (variant.get_type() == Variant::ARRAY) {
         Array array = variant.operator Array();
         if ((size_t)array.size() != results->size) return ERR_PARAMETER_RANGE_ERROR;
         for (uint16_t i = 0; i < results->size; i++) {
-          results->data[i] = encode_variant(array[i]);
+          results->data[i] = encode_variant(array[i], kinds[i]);
           if (results->data[i].kind == WASM_ANYREF) return ERR_INVALID_DATA;
         }
         return OK;
       } else if (results->size == 1) {
-        results->data[0] = encode_variant(variant);
+        results->data[0] = encode_variant(variant, kinds[0]);
         return results->data[0].kind == WASM_ANYREF ? ERR_INVALID_DATA : OK;
       } else return ERR_INVALID_DATA;
     }
 
+    Array flatten_values(const Array &values, const std::vector<Variant::Type>& types) {
+      // Expand declared math types into consecutive scalars
+      if (types.empty()) return values;
+      FAIL_IF((size_t)values.size() != types.size(), "Invalid value count", Array());
+      Array scalars;
+      for (uint16_t i = 0; i < values.size(); i++) {
+        if (types[i] == Variant::INT || types[i] == Variant::FLOAT || types[i] == Variant::BOOL) scalars.append(values[i]);
+        else if (values[i].get_type() == types[i]) godot_wasm::flatten(values[i], scalars);
+        else FAIL("Invalid value type " + Variant::get_type_name(values[i].get_type()), Array());
+      }
+      return scalars;
+    }
+
+    Array collapse_values(const Array &scalars, const std::vector<Variant::Type>& types) {
+      // Collapse consecutive scalars into declared math types
+      if (types.empty()) return scalars;
+      Array values;
+      uint32_t index = 0;
+      for (const auto &type: types) {
+        values.append(godot_wasm::collapse(type, scalars, index));
+        index += godot_wasm::flat_count(type);
+      }
+      return values;
+    }
+
+    godot_error parse_signature(const Variant &variant, size_t param_count, size_t result_count, godot_wasm::context_signature &signature) {
+      // Signature in the form [param_types, result_types] matching scalar counts once flattened
+      FAIL_IF(variant.get_type() != Variant::ARRAY || ((Array)variant).size() != 2, "Invalid signature", ERR_INVALID_PARAMETER);
+      const Array& types = variant;
+      FAIL_IF(types[0].get_type() != Variant::ARRAY || types[1].get_type() != Variant::ARRAY, "Invalid signature", ERR_INVALID_PARAMETER);
+      const size_t counts[2] = { param_count, result_count };
+      std::vector<Variant::Type>* lists[2] = { &signature.params, &signature.results };
+      for (uint8_t i = 0; i < 2; i++) {
+        const Array& list = types[i];
+        size_t count = 0;
+        lists[i]->clear();
+        for (uint16_t j = 0; j < list.size(); j++) {
+          Variant::Type type = (Variant::Type)(int64_t)list[j];
+          FAIL_IF(list[j].get_type() != Variant::INT || godot_wasm::flat_count(type) == 0, "Invalid signature type", ERR_INVALID_PARAMETER);
+          count += godot_wasm::flat_count(type);
+          lists[i]->push_back(type);
+        }
+        FAIL_IF(count != counts[i], "Signature mismatch", ERR_INVALID_PARAMETER);
+      }
+      return OK;
+    }
+
     Variant::Type get_value_type(const wasm_valkind_t& kind) {
       switch (kind) {
         case WASM_I32: case WASM_I64: return Variant::INT;
@@ -156,6 +337,13 @@ namespace godot {
           signature.append(get_value_type(wasm_valtype_kind(wasm_globaltype_content(global_type))));
           signature.append(Variant(wasm_globaltype_mutability(global_type) == WASM_VAR ? true : false));
           return signature;
+        } case WASM_EXTERN_TABLE: {
+          wasm_tabletype_t* table_type = wasm_externtype_as_tabletype((wasm_externtype_t*)type);
+          auto limits = wasm_tabletype_limits(table_type);
+          Array signature;
+          signature.append(limits->min);
+          signature.append(limits->max);
+          return signature;
         } default: FAIL("Unsupported extern type", Array());
       }
     }
@@ -173,9 +361,24 @@ namespace godot {
       Array params = Array();
       // TODO: Check if args and results match expected sizes
       for (uint16_t i = 0; i < args->size; i++) params.push_back(decode_variant(args->data[i]));
+      params = collapse_values(params, context->signature.params);
       // TODO: Ensure target is valid and has method
+      const bool stats = context->instrumentation && context->instrumentation->stats;
+      godot_wasm::Profiler* profiler = context->instrumentation ? context->instrumentation->profiler : NULL;
+      if (context->instrumentation && context->instrumentation->memory) context->instrumentation->memory->check_growth();
+      if (profiler) profiler->push(context->name);
+      TRACE_SCOPE(context->trace_name);
+      const uint64_t start = stats ? TIME_PRECISE : 0;
       Variant variant = context->target->callv(context->method, params);
-      godot_error error = extract_results(variant, results);
+      if (stats) context->stats.record(TIME_PRECISE - start);
+      if (profiler) profiler->pop();
+      if (!context->signature.results.empty()) {
+        Array values;
+        if (context->signature.results.size() == 1) values.append(variant);
+        else if (variant.get_type() == Variant::ARRAY) values = variant;
+        variant = flatten_values(values, context->signature.results);
+      }
+      godot_error error = extract_results(variant, results, context->results);
       if (error) FAIL("Extracting import function results failed", trap("Extracting import function results failed\0"));
       return NULL;
     }
@@ -196,28 +399,95 @@ namespace godot {
       ClassDB::bind_method(D_METHOD("compile", "bytecode"), &Wasm::compile);
       ClassDB::bind_method(D_METHOD("instantiate", "import_map"), &Wasm::instantiate);
       ClassDB::bind_method(D_METHOD("load", "bytecode", "import_map"), &Wasm::load);
+      ClassDB::bind_method(D_METHOD("compile_file", "path"), &Wasm::compile_file);
+      ClassDB::bind_method(D_METHOD("load_file", "path", "import_map"), &Wasm::load_file);
+      ClassDB::bind_method(D_METHOD("compile_module", "module"), &Wasm::compile_module);
+      ClassDB::bind_method(D_METHOD("load_module", "module", "import_map"), &Wasm::load_module);
+      ClassDB::bind_method(D_METHOD("redirect_output", "fd", "sink", "path"), &Wasm::redirect_output, DEFVAL(""));
+      ClassDB::bind_method(D_METHOD("flush_output", "partial"), &Wasm::flush_output, DEFVAL(true));
       ClassDB::bind_method(D_METHOD("inspect"), &Wasm::inspect);
       ClassDB::bind_method(D_METHOD("global", "name"), &Wasm::global);
+      ClassDB::bind_method(D_METHOD("set_global", "name", "value"), &Wasm::set_global);
+      ClassDB::bind_method(D_METHOD("call_indirect", "table", "index", "args"), &Wasm::call_indirect);
       ClassDB::bind_method(D_METHOD("function", "name", "args"), &Wasm::function);
+      ClassDB::bind_method(D_METHOD("function_typed", "name", "args", "type"), &Wasm::function_typed);
+      ClassDB::bind_method(D_METHOD("set_allocator", "name"), &Wasm::set_allocator);
+      ClassDB::bind_method(D_METHOD("get_allocator"), &Wasm::get_allocator);
+      ClassDB::bind_method(D_METHOD("set_scratch", "offset", "size"), &Wasm::set_scratch);
       ClassDB::bind_method(D_METHOD("set_permissions"), &Wasm::set_permissions);
       ClassDB::bind_method(D_METHOD("get_permissions"), &Wasm::get_permissions);
       ClassDB::bind_method(D_METHOD("has_permission", "permission"), &Wasm::has_permission);
       ClassDB::bind_method(D_METHOD("get_memory"), &Wasm::get_memory);
+      ClassDB::bind_method(D_METHOD("get_framebuffer"), &Wasm::get_framebuffer);
+      ClassDB::bind_method(D_METHOD("seed_random", "seed"), &Wasm::seed_random);
+      ClassDB::bind_method(D_METHOD("unseed_random"), &Wasm::unseed_random);
+      ClassDB::bind_method(D_METHOD("is_random_seeded"), &Wasm::is_random_seeded);
+      ClassDB::bind_method(D_METHOD("set_tiered", "enabled"), &Wasm::set_tiered);
+      ClassDB::bind_method(D_METHOD("is_tiered"), &Wasm::is_tiered);
+      ClassDB::bind_method(D_METHOD("is_optimized"), &Wasm::is_optimized);
+      ClassDB::bind_method(D_METHOD("set_deterministic", "enabled"), &Wasm::set_deterministic);
+      ClassDB::bind_method(D_METHOD("is_deterministic"), &Wasm::is_deterministic);
+      ClassDB::bind_method(D_METHOD("set_virtual_clock", "nsec"), &Wasm::set_virtual_clock);
+      ClassDB::bind_method(D_METHOD("get_virtual_clock"), &Wasm::get_virtual_clock);
+      ClassDB::bind_method(D_METHOD("get_state_hash"), &Wasm::get_state_hash);
+      ClassDB::bind_method(D_METHOD("set_stats_enabled", "enabled"), &Wasm::set_stats_enabled);
+      ClassDB::bind_method(D_METHOD("is_stats_enabled"), &Wasm::is_stats_enabled);
+      ClassDB::bind_method(D_METHOD("get_stats"), &Wasm::get_stats);
+      ClassDB::bind_method(D_METHOD("get_stat", "kind", "name", "field"), &Wasm::get_stat);
+      ClassDB::bind_method(D_METHOD("reset_stats"), &Wasm::reset_stats);
+      ClassDB::bind_method(D_METHOD("add_monitors", "prefix"), &Wasm::add_monitors);
+      ClassDB::bind_method(D_METHOD("remove_monitors"), &Wasm::remove_monitors);
+      ClassDB::bind_method(D_METHOD("start_profiling", "frequency"), &Wasm::start_profiling);
+      ClassDB::bind_method(D_METHOD("stop_profiling"), &Wasm::stop_profiling);
+      ClassDB::bind_static_method("Wasm", D_METHOD("start_tracing"), &Wasm::start_tracing);
+      ClassDB::bind_static_method("Wasm", D_METHOD("stop_tracing"), &Wasm::stop_tracing);
+      ClassDB::bind_static_method("Wasm", D_METHOD("dump_trace", "path"), &Wasm::dump_trace);
       ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "permissions"), "set_permissions", "get_permissions");
+      ADD_PROPERTY(PropertyInfo(Variant::STRING, "allocator"), "set_allocator", "get_allocator");
+      ADD_PROPERTY(PropertyInfo(Variant::BOOL, "stats_enabled"), "set_stats_enabled", "is_stats_enabled");
+      ADD_PROPERTY(PropertyInfo(Variant::BOOL, "tiered"), "set_tiered", "is_tiered");
+      ADD_PROPERTY(PropertyInfo(Variant::BOOL, "optimized"), "", "is_optimized");
+      ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "is_deterministic");
+      ADD_PROPERTY(PropertyInfo(Variant::INT, "virtual_clock", PROPERTY_HINT_NONE, "suffix:ns"), "set_virtual_clock", "get_virtual_clock");
       ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "memory"), "", "get_memory");
+      ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "framebuffer"), "", "get_framebuffer");
+      ADD_SIGNAL(MethodInfo("tiered_up"));
+      ADD_SIGNAL(MethodInfo("stdout_received", PropertyInfo(Variant::STRING, "text")));
+      ADD_SIGNAL(MethodInfo("stderr_received", PropertyInfo(Variant::STRING, "text")));
     #endif
   }
 
   Wasm::Wasm() {
+    store = NULL; // Shared store assigned on compilation such that construction does not create the engine
     module = NULL;
     instance = NULL;
     memory_context = NULL;
+    scratch_context = NULL;
+    allocator = "malloc";
+    instrumentation = new godot_wasm::context_instrumentation();
+    tier_context = NULL;
+    tiered = false;
+    call_depth = 0;
+    deterministic = false;
+    virtual_clock = 0;
+    output_contexts[0] = new godot_wasm::context_output();
+    output_contexts[1] = new godot_wasm::context_output();
+    output_queued = false;
+    filesystem = new godot_wasm::WasiFilesystem();
+    random = new godot_wasm::WasiRandom();
+    wasm_extern_vec_new_empty(&exports);
     reset_instance(); // Set initial state
   }
 
   Wasm::~Wasm() {
-    reset_instance();
-    unset(module, wasm_module_delete);
+    remove_monitors();
+    reset_module();
+    unset(instrumentation);
+    unset(output_contexts[0]);
+    unset(output_contexts[1]);
+    unset(filesystem);
+    unset(random);
+    if (store != NULL && store != STORE) wasm_store_delete(store);
   }
 
   void Wasm::_init() { }
@@ -228,12 +498,79 @@ namespace godot {
     // TODO: Emit signal
   }
 
+  void Wasm::write_output(int32_t fd, const char* data, size_t length) {
+    // Buffered and flushed once per frame; file descriptors other than stdout are treated as stderr
+    godot_wasm::context_output* context = output_contexts[fd == 1 ? 0 : 1];
+    if (context->sink == godot_wasm::context_output::SINK_DISCARD) return;
+    {
+      std::lock_guard<std::mutex> lock(context->mutex);
+      context->pending.append(data, length);
+    }
+    if (!output_queued.exchange(true)) call_deferred("flush_output", false);
+  }
+
+  void Wasm::flush_output(bool partial) {
+    // Complete lines are flushed unless partial lines are requested
+    output_queued = false;
+    for (uint8_t i = 0; i < 2; i++) {
+      godot_wasm::context_output* context = output_contexts[i];
+      std::string text;
+      {
+        std::lock_guard<std::mutex> lock(context->mutex);
+        std::string &pending = context->pending;
+        const size_t end = partial ? pending.size() : pending.rfind('\n') + 1; // Zero if no line feed
+        if (end == 0) continue;
+        text = pending.substr(0, end);
+        pending.erase(0, end);
+      }
+      if (text.back() == '\n') text.pop_back();
+      const String message = String::utf8(text.c_str(), text.length());
+      switch (context->sink) {
+        case godot_wasm::context_output::SINK_LOG: i == 0 ? PRINT(message) : PRINT_ERROR(message); break;
+        case godot_wasm::context_output::SINK_SIGNAL: emit_signal(i == 0 ? "stdout_received" : "stderr_received", message); break;
+        case godot_wasm::context_output::SINK_FILE: context->file->store_string(message + "\n"); context->file->flush(); break;
+        default: break;
+      }
+    }
+  }
+
+  godot_error Wasm::redirect_output(int32_t fd, const String &sink, const String &path) {
+    FAIL_IF(fd != 1 && fd != 2, "Invalid output file descriptor", ERR_INVALID_PARAMETER);
+    flush_output(true); // Output written prior to redirection
+    godot_wasm::context_output* context = output_contexts[fd - 1];
+    Ref<FileAccess> file;
+    if (sink == "file") {
+      file = FileAccess::open(path, FileAccess::WRITE);
+      FAIL_IF(file.is_null(), "Failed to open file " + path, ERR_FILE_CANT_OPEN);
+    }
+    if (sink == "log") context->sink = godot_wasm::context_output::SINK_LOG;
+    else if (sink == "signal") context->sink = godot_wasm::context_output::SINK_SIGNAL;
+    else if (sink == "file") context->sink = godot_wasm::context_output::SINK_FILE;
+    else if (sink == "discard") context->sink = godot_wasm::context_output::SINK_DISCARD;
+    else FAIL("Invalid output sink " + sink, ERR_INVALID_PARAMETER);
+    context->file = file;
+    return OK;
+  }
+
   void Wasm::reset_instance() {
+    flush_output(true); // Output of previous instance
+    remove_monitors(); // Monitors reference module imports and exports
+    wasm_extern_vec_delete(&exports);
+    wasm_extern_vec_new_empty(&exports);
     unset(instance, wasm_instance_delete);
     unset(memory_context);
+    unset(scratch_context);
+    scratch_context = new godot_wasm::context_scratch();
     memory = Ref<WasmMemory>(NULL);
+    instrumentation->memory = NULL;
+    framebuffer = Ref<WasmFramebuffer>(NULL);
+    linked.clear();
+    filesystem->reset();
     import_funcs.clear();
+    import_globals.clear();
+    import_tables.clear();
     export_globals.clear();
+    export_tables.clear();
     export_funcs.clear();
     permissions.clear();
     permissions["print"] = true;
@@ -241,12 +578,307 @@ namespace godot {
     permissions["random"] = true;
     permissions["args"] = true;
     permissions["exit"] = true;
+    permissions["filesystem"] = false;
+  }
+
+  void Wasm::reset_module() {
+    reset_instance();
+    // Modules compiled from a resource are owned by and may be shared with the resource
+    if (module_resource.is_valid()) module = NULL;
+    else unset(module, wasm_module_delete);
+    module_resource.unref();
+    // Restore store replaced by baseline engine store
+    if (tier_context != NULL) {
+      wasm_store_delete(store);
+      store = tier_context->store;
+      unset(tier_context);
+    }
+  }
+
+  void Wasm::isolate() {
+    // Use a store private to this instance; required to call into the module from a thread other than the main thread
+    reset_module(); // Also restores store replaced by baseline engine store
+    if (store != NULL && store != STORE) return;
+    store = wasm_store_new(::godot_wasm::Store::instance().engine);
+  }
+
+  const wasm_extern_t* Wasm::find_export(const String &name) const {
+    // Export of any kind; borrowed from cached exports
+    if (instance == NULL) return NULL;
+    wasm_exporttype_vec_t types;
+    DEFER(wasm_exporttype_vec_delete(&types));
+    wasm_module_exports(module, &types);
+    for (size_t i = 0; i < types.size && i < exports.size; i++) {
+      if (decode_name(wasm_exporttype_name(types.data[i])) == name) return exports.data[i];
+    }
+    return NULL;
+  }
+
+  const wasm_func_t* Wasm::get_export_function(const String &name) const {
+    // Borrowed from cached exports; valid until the instance is reset
+    if (instance == NULL || !export_funcs.count(name)) return NULL;
+    return wasm_extern_as_func(exports.data[export_funcs.at(name).index]);
   }
 
   Ref<WasmMemory> Wasm::get_memory() const {
     return memory;
   };
 
+  void Wasm::set_allocator(const String &name) {
+    allocator = name;
+  }
+
+  String Wasm::get_allocator() const {
+    return allocator;
+  }
+
+  godot_error Wasm::set_scratch(uint32_t offset, uint32_t size) {
+    // Use memory reserved by the module for marshalled arguments rather than calling the module allocator
+    FAIL_IF(instance == NULL, "Not instantiated", ERR_UNCONFIGURED);
+    FAIL_IF(memory.is_null() || memory->get_memory() == NULL, "Invalid memory", ERR_INVALID_DATA);
+    FAIL_IF((size_t)offset + size > wasm_memory_data_size(memory->get_memory()), "Scratch memory out of bounds", ERR_PARAMETER_RANGE_ERROR);
+    FAIL_IF(scratch_context->used > 0, "Scratch memory in use", ERR_BUSY);
+    release_scratch();
+    scratch_context->offset = offset;
+    scratch_context->capacity = size;
+    scratch_context->host = true;
+    return OK;
+  }
+
+  godot_error Wasm::reserve_scratch(size_t size) {
+    if (scratch_context->used + size <= scratch_context->capacity) return OK;
+    FAIL_IF(scratch_context->host || scratch_context->used > 0, "Scratch memory exhausted", ERR_OUT_OF_MEMORY);
+    FAIL_IF(!export_funcs.count(allocator), "Missing allocator export " + allocator, ERR_UNAVAILABLE);
+    release_scratch();
+
+    // Call module allocator e.g. malloc(size) or AssemblyScript __new(size, id)
+    uint32_t capacity = next_power_of_2((uint32_t)MAX(size, (size_t)SCRATCH_SIZE_MIN));
+    Array args;
+    args.append((int64_t)capacity);
+    if (export_funcs.at(allocator).params.size() > 1) args.append(1); // AssemblyScript ArrayBuffer class ID
+    Variant offset = function(allocator, args);
+    FAIL_IF(offset.get_type() != Variant::INT || (int64_t)offset <= 0, "Scratch memory allocation failed", ERR_OUT_OF_MEMORY);
+    if (export_funcs.count("__pin")) {
+      Array pin;
+      pin.append(offset);
+      function("__pin", pin);
+    }
+    scratch_context->offset = (uint32_t)(int64_t)offset;
+    scratch_context->capacity = capacity;
+    return OK;
+  }
+
+  void Wasm::release_scratch() {
+    // Return scratch memory to module allocator
+    if (scratch_context->capacity == 0) return;
+    if (!scratch_context->host) {
+      Array args;
+      args.append((int64_t)scratch_context->offset);
+      if (export_funcs.count("__unpin")) function("__unpin", args);
+      else if (export_funcs.count("free")) function("free", args);
+    }
+    scratch_context->offset = 0;
+    scratch_context->capacity = 0;
+    scratch_context->host = false;
+  }
+
+  Ref<WasmFramebuffer> Wasm::get_framebuffer() const {
+    return framebuffer;
+  }
+
+  godot_wasm::WasiFilesystem* Wasm::get_filesystem() const {
+    return filesystem;
+  }
+
+  godot_wasm::WasiRandom* Wasm::get_random() const {
+    return random;
+  }
+
+  void Wasm::seed_random(int64_t seed) {
+    random->seed(seed); // Applies immediately and from each instantiation
+  }
+
+  void Wasm::unseed_random() {
+    random->unseed();
+  }
+
+  bool Wasm::is_random_seeded() const {
+    return random->is_seeded();
+  }
+
+  void Wasm::set_tiered(bool enabled) {
+    tiered = enabled; // Applies from next compilation
+  }
+
+  bool Wasm::is_tiered() const {
+    return tiered;
+  }
+
+  bool Wasm::is_optimized() const {
+    return module != NULL && tier_context == NULL;
+  }
+
+  void Wasm::set_deterministic(bool enabled) {
+    // Float results are canonicalized by the shared engine, so only if configured before it is created
+    if (enabled) {
+      FAIL_IF(!WasmEngineConfig::is_supported("determinism/nan_canonicalization"), "NaN canonicalization unsupported by runtime", );
+      FAIL_IF(!WasmEngineConfig::get_setting("determinism/nan_canonicalization"), "NaN canonicalization requires project setting " ENGINE_SETTINGS_PREFIX "determinism/nan_canonicalization", );
+      if (!random->is_seeded()) random->seed(0);
+    }
+    deterministic = enabled;
+  }
+
+  bool Wasm::is_deterministic() const {
+    return deterministic;
+  }
+
+  void Wasm::set_virtual_clock(int64_t nsec) {
+    virtual_clock = nsec;
+  }
+
+  int64_t Wasm::get_virtual_clock() const {
+    return virtual_clock;
+  }
+
+  int64_t Wasm::get_state_hash() const {
+    // Linear memory and exported mutable globals, which peers in lockstep compare each frame
+    FAIL_IF(instance == NULL, "Not instantiated", 0);
+    uint64_t hash = 0xcbf29ce484222325;
+    if (memory.is_valid() && memory->get_memory() != NULL) {
+      wasm_memory_t* data = memory->get_memory();
+      hash = hash_bytes((const uint8_t*)wasm_memory_data(data), wasm_memory_data_size(data), hash);
+    }
+    for (const auto &it: export_globals) { // Sorted by name
+      const wasm_global_t* global = wasm_extern_as_global(exports.data[it.second.index]);
+      wasm_globaltype_t* type = wasm_global_type(global);
+      const bool var = wasm_globaltype_mutability(type) == WASM_VAR;
+      wasm_globaltype_delete(type);
+      if (!var) continue;
+      wasm_val_t value;
+      wasm_global_get(global, &value);
+      uint64_t bits = 0;
+      if (value.kind == WASM_I32 || value.kind == WASM_F32) bits = (uint32_t)value.of.i32;
+      else if (value.kind == WASM_I64 || value.kind == WASM_F64) bits = value.of.i64;
+      hash = hash_bytes((const uint8_t*)&bits, sizeof(bits), hash);
+    }
+    return hash;
+  }
+
+  void Wasm::set_stats_enabled(bool enabled) {
+    instrumentation->stats = enabled;
+  }
+
+  bool Wasm::is_stats_enabled() const {
+    return instrumentation->stats;
+  }
+
+  Dictionary Wasm::get_stats() const {
+    // Call counts and durations of exports and imports called at least once
+    Dictionary exports_dict, imports_dict;
+    for (const auto &it: export_funcs) if (it.second.stats.calls) exports_dict[it.first] = it.second.stats.to_dictionary();
+    for (const auto &it: import_funcs) if (it.second.stats.calls) imports_dict[it.first] = it.second.stats.to_dictionary();
+    Dictionary dict;
+    dict["exports"] = exports_dict;
+    dict["imports"] = imports_dict;
+    dict["memory"] = memory.is_valid() ? memory->inspect() : Dictionary();
+    return dict;
+  }
+
+  const godot_wasm::context_stats* Wasm::find_stats(const String &kind, const String &name) const {
+    if (kind == "exports" && export_funcs.count(name)) return &export_funcs.at(name).stats;
+    if (kind == "imports" && import_funcs.count(name)) return &import_funcs.at(name).stats;
+    return NULL;
+  }
+
+  Variant Wasm::get_stat(const String &kind, const String &name, const String &field) const {
+    // Single statistic suitable for a Performance custom monitor
+    if (kind == "memory" && field == "resident") return memory.is_valid() ? memory->get_resident_size() : 0;
+    if (kind == "memory") return memory.is_valid() ? dict_safe_get(memory->inspect(), field, 0) : Variant(0);
+    const godot_wasm::context_stats* stats = find_stats(kind, name);
+    FAIL_IF(stats == NULL, "Unknown " + kind + " " + name, NULL_VARIANT);
+    return dict_safe_get(stats->to_dictionary(), field, 0);
+  }
+
+  void Wasm::reset_stats() {
+    for (auto &it: export_funcs) it.second.stats = godot_wasm::context_stats();
+    for (auto &it: import_funcs) it.second.stats = godot_wasm::context_stats();
+  }
+
+  void Wasm::add_monitors(const String &prefix) {
+    // Register Performance custom monitors in the form prefix/name field
+    FAIL_IF(instance == NULL, "Not instantiated", );
+    remove_monitors();
+    Performance* performance = Performance::get_singleton();
+    const char* fields[3] = { "calls", "total_usec", "max_usec" };
+    std::vector<std::pair<String, String>> externs;
+    for (const auto &it: export_funcs) externs.push_back({ "exports", it.first });
+    for (const auto &it: import_funcs) externs.push_back({ "imports", it.first });
+    std::vector<std::pair<String, Array>> entries; // Monitor ID and get_stat arguments
+    for (const auto &it: externs) {
+      for (const auto &field: fields) {
+        Array args;
+        args.append(it.first);
+        args.append(it.second);
+        args.append(field);
+        entries.push_back({ prefix + "/" + it.second + " " + field, args });
+      }
+    }
+    const std::pair<const char*, const char*> memory_fields[2] = { { "/memory", "current" }, { "/memory resident", "resident" } };
+    for (const auto &it: memory_fields) {
+      Array args;
+      args.append("memory");
+      args.append("");
+      args.append(it.second);
+      entries.push_back({ prefix + it.first, args });
+    }
+    // Monitors registered under the same prefix by another instance would otherwise be removed by this one
+    for (const auto &it: entries) FAIL_IF(performance->has_custom_monitor(it.first), "Monitor " + it.first + " already registered", );
+    for (const auto &it: entries) {
+      performance->add_custom_monitor(it.first, Callable(this, "get_stat"), it.second);
+      monitors.append(it.first);
+    }
+  }
+
+  godot_error Wasm::start_profiling(int32_t frequency) {
+    // Sample boundary call stacks from a separate thread
+    FAIL_IF(frequency <= 0, "Invalid profiling frequency", ERR_INVALID_PARAMETER);
+    FAIL_IF(instrumentation->profiler != NULL, "Already profiling", ERR_ALREADY_IN_USE);
+    instrumentation->profiler = new godot_wasm::Profiler();
+    instrumentation->profiler->start(frequency);
+    return OK;
+  }
+
+  String Wasm::stop_profiling() {
+    FAIL_IF(instrumentation->profiler == NULL, "Not profiling", String());
+    String profile = instrumentation->profiler->stop();
+    if (call_depth > 0) { // Stopped by import callback; enclosing calls pop frames on return
+      instrumentation->stopped.push_back(instrumentation->profiler);
+      instrumentation->profiler = NULL;
+    } else unset(instrumentation->profiler);
+    return profile;
+  }
+
+  void Wasm::start_tracing() {
+    godot_wasm::Tracer::start();
+  }
+
+  void Wasm::stop_tracing() {
+    godot_wasm::Tracer::stop();
+  }
+
+  godot_error Wasm::dump_trace(const String &path) {
+    return godot_wasm::Tracer::dump(path);
+  }
+
+  void Wasm::remove_monitors() {
+    if (monitors.is_empty()) return;
+    Performance* performance = Performance::get_singleton();
+    for (auto i = 0; i < monitors.size(); i++) {
+      if (performance && performance->has_custom_monitor(monitors[i])) performance->remove_custom_monitor(monitors[i]);
+    }
+    monitors.clear();
+  }
+
   void Wasm::set_permissions(const Dictionary &update) {
     for (auto i = 0; i < permissions.keys().size(); i++) {
       Variant key = permissions.keys()[i];
@@ -263,22 +895,191 @@ namespace godot {
   }
 
   godot_error Wasm::compile(PackedByteArray bytecode) {
-    reset_instance(); // Reset instance
-    unset(module, wasm_module_delete); // Reset module
+    // Bytes are borrowed by the runtime for the duration of compilation; no copy required
+    const wasm_byte_vec_t bytes = { (size_t)bytecode.size(), (wasm_byte_t*)BYTE_ARRAY_POINTER(bytecode) };
+    return compile_bytes(&bytes);
+  }
+
+  godot_error Wasm::compile_file(String path) {
+    // Map file into memory if on host filesystem
+    godot_wasm::MappedFile mapped;
+    if (mapped.open(path) == OK) {
+      const wasm_byte_vec_t bytes = { mapped.get_size(), (wasm_byte_t*)mapped.get_data() };
+      return compile_bytes(&bytes);
+    }
+
+    // Stream file into a single buffer e.g. from PCK
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    FAIL_IF(file.is_null(), "Failed to open file " + path, ERR_FILE_CANT_OPEN);
+    wasm_byte_vec_t bytes;
+    DEFER(wasm_byte_vec_delete(&bytes));
+    wasm_byte_vec_new_uninitialized(&bytes, file->get_length());
+    FAIL_IF(godot_wasm::read_file(file, (uint8_t*)bytes.data, bytes.size) != bytes.size, "Failed to read file " + path, ERR_FILE_CANT_READ);
+    return compile_bytes(&bytes);
+  }
+
+  godot_error Wasm::compile_bytes(const wasm_byte_vec_t* bytes) {
+    // Decompress gzip or zstd compressed module into a single buffer lent to the runtime
+    if (godot_wasm::is_compressed((const uint8_t*)bytes->data, bytes->size)) {
+      PackedByteArray decompressed;
+      godot_error err = godot_wasm::decompress((const uint8_t*)bytes->data, bytes->size, decompressed);
+      FAIL_IF(err != OK, "Failed to decompress module", err);
+      const wasm_byte_vec_t raw = { (size_t)decompressed.size(), (wasm_byte_t*)BYTE_ARRAY_POINTER(decompressed) };
+      return compile_bytes(&raw);
+    }
 
-    // Load binary
-    wasm_byte_vec_t wasm_bytes;
-    DEFER(wasm_byte_vec_delete(&wasm_bytes));
-    wasm_byte_vec_new_uninitialized(&wasm_bytes, bytecode.size());
-    memcpy(wasm_bytes.data, BYTE_ARRAY_POINTER(bytecode), bytecode.size());
+    reset_module(); // Reset module and instance
+    if (store == NULL) store = STORE; // Creates engine on first compilation
+
+    // Instantiate baseline module while optimized module compiles in the background
+    if (tiered && ::godot_wasm::Store::instance().baseline_engine != NULL) return compile_tiered(bytes);
 
     // Validate binary
-    FAIL_IF(!wasm_module_validate(STORE, &wasm_bytes), "Invalid binary", ERR_INVALID_DATA);
+    FAIL_IF(!wasm_module_validate(store, bytes), "Invalid binary", ERR_INVALID_DATA);
 
     // Compile
-    module = wasm_module_new(STORE, &wasm_bytes);
+    module = wasm_module_new(store, bytes);
     FAIL_IF(module == NULL, "Compilation failed", ERR_COMPILATION_FAILED);
 
+    // Map guest function indices to names for profiling
+    function_names = godot_wasm::parse_function_names((const uint8_t*)bytes->data, bytes->size);
+
+    // Map names to export indices
+    FAIL_IF(map_names(), "Failed to parse module imports or exports", ERR_COMPILATION_FAILED);
+
+    return OK;
+  }
+
+  godot_error Wasm::compile_tiered(const wasm_byte_vec_t* bytes) {
+    // Validate binary
+    FAIL_IF(!wasm_module_validate(store, bytes), "Invalid binary", ERR_INVALID_DATA);
+
+    // Compile baseline module; instances of baseline engine modules require a baseline engine store
+    tier_context = new godot_wasm::context_tier(store);
+    store = wasm_store_new(::godot_wasm::Store::instance().baseline_engine);
+    module = wasm_module_new(store, bytes);
+    FAIL_IF(module == NULL, "Compilation failed", ERR_COMPILATION_FAILED);
+
+    // Map guest function indices to names for profiling
+    function_names = godot_wasm::parse_function_names((const uint8_t*)bytes->data, bytes->size);
+
+    // Map names to export indices
+    FAIL_IF(map_names(), "Failed to parse module imports or exports", ERR_COMPILATION_FAILED);
+    FAIL_IF(memory_context && memory_context->import, "Tiered compilation unavailable to module importing memory", ERR_UNAVAILABLE);
+
+    // Remain on baseline tier if instance state can not be transferred to optimized instance
+    const godot_wasm::instance_state state = godot_wasm::parse_instance_state((const uint8_t*)bytes->data, bytes->size);
+    if (!state.valid || state.start || state.hidden_globals > 0 || state.tables) return OK;
+
+    // Compile optimized module with default engine on worker thread; bytes are only borrowed so are copied
+    godot_wasm::context_tier* context = tier_context;
+    wasm_byte_vec_t copy;
+    wasm_byte_vec_new(&copy, bytes->size, bytes->data);
+    context->thread = std::thread([context, copy]() mutable {
+      wasm_store_t* store = wasm_store_new(::godot_wasm::Store::instance().engine);
+      context->optimized = wasm_module_new(store, &copy);
+      wasm_store_delete(store); // Modules outlive the store used to compile them
+      wasm_byte_vec_delete(&copy);
+      context->ready = true;
+    });
+
+    return OK;
+  }
+
+  godot_error Wasm::swap_tier() {
+    // Called between export calls once optimized module is ready
+    tier_context->thread.join();
+    tier_context->ready = false;
+    wasm_module_t* optimized = tier_context->optimized;
+    tier_context->optimized = NULL;
+    FAIL_IF(optimized == NULL, "Optimized compilation failed", ERR_COMPILATION_FAILED); // Continue with baseline module
+
+    // Retain baseline instance until optimized instance is created; modules are identical so mapped names are reused
+    wasm_instance_t* baseline_instance = instance;
+    wasm_extern_vec_t baseline_exports = exports;
+    wasm_store_t* baseline_store = store;
+    wasm_module_t* baseline_module = module;
+    Ref<WasmMemory> memory_ref = memory;
+    Ref<WasmFramebuffer> framebuffer_ref = framebuffer;
+    godot_wasm::WasiFilesystem* filesystem_ref = filesystem; // Open descriptors remain valid
+    instance = NULL;
+    wasm_extern_vec_new_empty(&exports);
+    store = tier_context->store;
+    module = optimized;
+    filesystem = new godot_wasm::WasiFilesystem();
+
+    // Instantiate optimized module
+    godot_error err = create_instance(tier_context->import_map);
+    std::swap(filesystem, filesystem_ref);
+    delete filesystem_ref;
+    memory.swap(memory_ref); // Memory of optimized instance if any
+    framebuffer = framebuffer_ref;
+    instrumentation->memory = memory.ptr();
+
+    // Grow memory of optimized instance to that of baseline instance before any state is transferred
+    wasm_memory_t* source = memory.is_valid() && memory_ref.is_valid() ? memory->get_memory() : NULL;
+    wasm_memory_t* target = source != NULL ? memory_ref->get_memory() : NULL;
+    if (err == OK && source != NULL) {
+      if (wasm_memory_size(target) < wasm_memory_size(source)) wasm_memory_grow(target, wasm_memory_size(source) - wasm_memory_size(target));
+      if (wasm_memory_data_size(target) < wasm_memory_data_size(source)) {
+        PRINT_ERROR("Failed to transfer memory");
+        err = ERR_CANT_CREATE;
+      }
+    }
+    if (err != OK) {
+      // Restore baseline instance and store; reset_module deletes the baseline store while tier context remains
+      wasm_extern_vec_delete(&exports);
+      unset(instance, wasm_instance_delete);
+      wasm_module_delete(optimized);
+      instance = baseline_instance;
+      exports = baseline_exports;
+      store = baseline_store;
+      module = baseline_module;
+      FAIL("Failed to instantiate optimized module", err);
+    }
+
+    // Transfer memory into existing WasmMemory such that references held by callers remain valid
+    if (source != NULL) {
+      memcpy(wasm_memory_data(target), wasm_memory_data(source), wasm_memory_data_size(source));
+      memory->set_memory(wasm_extern_as_memory(wasm_extern_copy(exports.data[memory_context->index]))); // Replaces extern of baseline store
+    }
+
+    // Transfer exported mutable globals; module has no other mutable globals
+    for (const auto &it: export_globals) {
+      const wasm_global_t* source = wasm_extern_as_global(baseline_exports.data[it.second.index]);
+      wasm_global_t* target = wasm_extern_as_global(exports.data[it.second.index]);
+      wasm_globaltype_t* type = wasm_global_type(source);
+      const bool var = wasm_globaltype_mutability(type) == WASM_VAR;
+      wasm_globaltype_delete(type);
+      if (!var) continue;
+      wasm_val_t value;
+      wasm_global_get(source, &value);
+      if (wasm_valkind_is_num(value.kind)) wasm_global_set(target, &value);
+    }
+
+    // Release baseline instance, module, and store; monitors and statistics refer to names so remain valid
+    wasm_extern_vec_delete(&baseline_exports);
+    wasm_instance_delete(baseline_instance);
+    wasm_module_delete(baseline_module);
+    wasm_store_delete(baseline_store);
+    unset(tier_context);
+
+    emit_signal("tiered_up");
+    return OK;
+  }
+
+  godot_error Wasm::compile_module(Ref<WasmModule> resource) {
+    // Module was compiled or deserialized when the resource was loaded
+    FAIL_IF(resource.is_null() || resource->get_module() == NULL, "Invalid module", ERR_INVALID_PARAMETER);
+    reset_module();
+    if (store == NULL) store = STORE;
+    module_resource = resource;
+    module = (wasm_module_t*)resource->get_module();
+
+    // Map guest function indices to names for profiling
+    const PackedByteArray bytecode = resource->get_bytecode();
+    function_names = godot_wasm::parse_function_names(BYTE_ARRAY_POINTER(bytecode), bytecode.size());
+
     // Map names to export indices
     FAIL_IF(map_names(), "Failed to parse module imports or exports", ERR_COMPILATION_FAILED);
 
@@ -286,63 +1087,165 @@ namespace godot {
   }
 
   godot_error Wasm::instantiate(const Dictionary import_map) {
+    FAIL_IF(module == NULL || store == NULL, "Not compiled", ERR_UNCONFIGURED);
+    random->restart();
+    godot_error err = create_instance(import_map);
+    if (err != OK) return err;
+
+    // Retain imports to instantiate optimized module
+    if (tier_context != NULL) tier_context->import_map = import_map;
+
+    // Call exported WASI initialize function
+    if (export_funcs.count("_initialize")) function("_initialize", Array());
+
+    return OK;
+  }
+
+  godot_error Wasm::create_instance(const Dictionary &import_map) {
     // Prepare module externs
     std::map<uint16_t, wasm_extern_t*> extern_map;
     DEFER(for (auto &it: extern_map) wasm_extern_delete(it.second));
 
+    // Link imports to exports of other instances by module name, bypassing host callbacks
+    const Dictionary& modules = dict_safe_get(import_map, "modules", Dictionary());
+    if (!modules.is_empty()) {
+      FAIL_IF(store != STORE, "Linked imports unavailable to isolated or tiered instance", ERR_CANT_CREATE);
+      wasm_importtype_vec_t import_types;
+      DEFER(wasm_importtype_vec_delete(&import_types));
+      wasm_module_imports(module, &import_types);
+      for (uint16_t i = 0; i < import_types.size; i++) {
+        const String module_name = decode_name(wasm_importtype_module(import_types.data[i]));
+        if (!modules.has(module_name)) continue;
+        const String key = module_name + "." + decode_name(wasm_importtype_name(import_types.data[i]));
+        Wasm* other = dict_safe_get<Wasm>(modules, module_name);
+        FAIL_IF(other == NULL || other->instance == NULL, "Invalid linked instance " + module_name, ERR_CANT_CREATE);
+        FAIL_IF(other->store != STORE, "Linked instance isolated or tiered " + module_name, ERR_CANT_CREATE);
+        const wasm_extern_t* data = other->find_export(decode_name(wasm_importtype_name(import_types.data[i])));
+        FAIL_IF(data == NULL, "Missing linked export " + key, ERR_CANT_CREATE);
+        FAIL_IF(wasm_extern_kind(data) != wasm_externtype_kind(wasm_importtype_type(import_types.data[i])), "Invalid linked export " + key, ERR_CANT_CREATE);
+        extern_map[i] = wasm_extern_copy((wasm_extern_t*)data);
+        if (!linked.has(other)) linked.append(other);
+      }
+    }
+
     // Construct import functions
     const Dictionary& functions = dict_safe_get(import_map, "functions", Dictionary());
     for (const auto &it: import_funcs) {
+      if (extern_map.count(it.second.index)) continue; // Linked
       if (!functions.keys().has(it.first)) {
         // Attempt to use default WASI import
-        auto callback = godot_wasm::get_wasi_callback(STORE, this, it.first);
+        auto callback = godot_wasm::get_wasi_callback(store, this, it.first);
         FAIL_IF(callback == NULL, "Missing import function " + it.first, ERR_CANT_CREATE);
         extern_map[it.second.index] = wasm_func_as_extern(callback);
         continue;
       }
       const Array& import = dict_safe_get(functions, it.first, Array());
-      FAIL_IF(import.size() != 2, "Invalid import function " + it.first, ERR_CANT_CREATE);
+      FAIL_IF(import.size() != 2 && import.size() != 3, "Invalid import function " + it.first, ERR_CANT_CREATE);
       FAIL_IF(import[0].get_type() != Variant::OBJECT, "Invalid import target", ERR_CANT_CREATE);
       FAIL_IF(import[1].get_type() != Variant::STRING, "Invalid import method", ERR_CANT_CREATE);
       godot_wasm::context_func_import* context = (godot_wasm::context_func_import*)&it.second;
       context->target = import[0];
       context->method = import[1];
+      context->signature = godot_wasm::context_signature();
+      context->instrumentation = instrumentation;
+      if (import.size() == 3) {
+        const Array signature = get_extern_signature(module, it.second.index, true);
+        FAIL_IF(parse_signature(import[2], ((Array)signature[0]).size(), ((Array)signature[1]).size(), context->signature), "Invalid import signature " + it.first, ERR_CANT_CREATE);
+      }
       extern_map[it.second.index] = wasm_func_as_extern(create_callback(context));
     }
 
+    // Declare export signatures flattening math types
+    const Dictionary& signatures = dict_safe_get(import_map, "export_signatures", Dictionary());
+    for (auto &it: export_funcs) {
+      it.second.signature = godot_wasm::context_signature();
+      if (!signatures.has(it.first)) continue;
+      FAIL_IF(parse_signature(signatures[it.first], it.second.params.size(), it.second.return_count, it.second.signature), "Invalid export signature " + it.first, ERR_CANT_CREATE);
+    }
+
     // Configure import memory
     WasmMemory* import_memory = NULL;
-    if (memory_context && memory_context->import) {
+    if (memory_context && memory_context->import && !extern_map.count(memory_context->index)) {
       import_memory = dict_safe_get<WasmMemory>(import_map, "memory");
       FAIL_IF(import_memory == NULL, "Missing import memory", ERR_CANT_CREATE);
       FAIL_IF(import_memory->get_memory() == NULL, "Invalid import memory", ERR_CANT_CREATE);
+      FAIL_IF(import_memory->is_view(), "Memory view can not be imported", ERR_CANT_CREATE);
+      FAIL_IF(store != STORE, "Import memory unavailable to isolated instance", ERR_CANT_CREATE);
       // TODO: Validate memory limits
       extern_map[memory_context->index] = wasm_extern_copy(wasm_memory_as_extern(import_memory->get_memory()));
     }
 
+    // Construct import globals from provided values
+    const Dictionary& globals = dict_safe_get(import_map, "globals", Dictionary());
+    for (const auto &it: import_globals) {
+      if (extern_map.count(it.second.index)) continue; // Linked
+      FAIL_IF(!globals.has(it.first), "Missing import global " + it.first, ERR_CANT_CREATE);
+      wasm_externtype_t* type = get_extern_type(module, it.second.index, true);
+      DEFER(wasm_externtype_delete(type));
+      const wasm_globaltype_t* global_type = wasm_externtype_as_globaltype(type);
+      const wasm_valkind_t kind = wasm_valtype_kind(wasm_globaltype_content(global_type));
+      const wasm_val_t value = encode_variant(globals[it.first], kind);
+      FAIL_IF(value.kind != kind, "Invalid import global " + it.first, ERR_CANT_CREATE);
+      extern_map[it.second.index] = wasm_global_as_extern(wasm_global_new(store, global_type, &value));
+    }
+
+    // Construct empty import tables; populated by module element segments
+    for (const auto &it: import_tables) {
+      if (extern_map.count(it.second.index)) continue; // Linked
+      #ifdef WASMER
+        FAIL("Import table " + it.first + " must be linked; table creation unsupported by Wasmer C API", ERR_UNAVAILABLE);
+      #else
+        wasm_externtype_t* type = get_extern_type(module, it.second.index, true);
+        DEFER(wasm_externtype_delete(type));
+        wasm_table_t* table = wasm_table_new(store, wasm_externtype_as_tabletype(type), NULL);
+        FAIL_IF(table == NULL, "Invalid import table " + it.first, ERR_CANT_CREATE);
+        extern_map[it.second.index] = wasm_table_as_extern(table);
+      #endif
+    }
+
+    // Preopen directories for WASI filesystem; guest paths map to Godot paths
+    Dictionary preopens;
+    preopens["/res"] = "res://";
+    preopens["/user"] = "user://";
+    preopens = dict_safe_get(import_map, "preopens", preopens);
+    filesystem->reset(); // Descriptors of any previous instance
+    for (auto i = 0; i < preopens.keys().size(); i++) {
+      const Variant guest = preopens.keys()[i];
+      FAIL_IF(filesystem->preopen(guest, preopens[guest]) != OK, "Invalid preopen " + String(guest), ERR_CANT_CREATE);
+    }
+
     // Sort imports by index
     std::vector<wasm_extern_t*> extern_list;
     for (auto &it: extern_map) extern_list.push_back(it.second); // Maps iterate over sorted keys
     wasm_extern_vec_t imports = { extern_list.size(), extern_list.data() };
 
     // Instantiate with imports
-    instance = wasm_instance_new(STORE, module, &imports, NULL);
+    instance = wasm_instance_new(store, module, &imports, NULL);
     FAIL_IF(instance == NULL, "Instantiation failed", ERR_CANT_CREATE);
+    INSTANTIATE_REF(framebuffer);
+
+    // Cache exports for lookup by index
+    wasm_extern_vec_delete(&exports);
+    wasm_instance_exports(instance, &exports);
 
     // Set memory reference
     if (import_memory) {
       memory = Ref<WasmMemory>(import_memory);
-    } else if (memory_context && !memory_context->import) {
-      wasm_extern_vec_t exports;
-      DEFER(wasm_extern_vec_delete(&exports));
-      wasm_instance_exports(instance, &exports);
-      wasm_extern_t* data = exports.data[memory_context->index];
+    } else if (memory_context) {
+      // Exported memory or memory linked from another instance
+      wasm_extern_t* data = memory_context->import ? extern_map[memory_context->index] : exports.data[memory_context->index];
       INSTANTIATE_REF(memory);
       memory->set_memory(wasm_extern_as_memory(wasm_extern_copy(data)));
     }
+    instrumentation->memory = memory.ptr();
 
-    // Call exported WASI initialize function
-    if (export_funcs.count("_initialize")) function("_initialize", Array());
+    // Configure host pages backing memory
+    const Dictionary& backing = dict_safe_get(import_map, "memory_backing", Dictionary());
+    if (memory.is_valid() && !backing.is_empty()) {
+      if (dict_safe_get(backing, "hugepages", false)) memory->advise_hugepages(true);
+      const int64_t prefault = dict_safe_get(backing, "prefault", 0);
+      if (prefault != 0) memory->prefault(prefault);
+    }
 
     return OK;
   }
@@ -354,20 +1257,40 @@ namespace godot {
     return instantiate(import_map);
   }
 
+  godot_error Wasm::load_file(String path, const Dictionary import_map) {
+    // Compile from file and instantiate in one go
+    godot_error err = compile_file(path);
+    if (err != OK) return err;
+    return instantiate(import_map);
+  }
+
+  godot_error Wasm::load_module(Ref<WasmModule> resource, const Dictionary import_map) {
+    // Use resource module and instantiate in one go
+    godot_error err = compile_module(resource);
+    if (err != OK) return err;
+    return instantiate(import_map);
+  }
+
   Dictionary Wasm::inspect() const {
     // Validate module
     FAIL_IF(module == NULL, "Inspection failed", Dictionary());
 
     // Module extern names and signatures
-    Dictionary import_func_sigs, export_global_sigs, export_func_sigs;
+    Dictionary import_func_sigs, import_global_sigs, import_table_sigs, export_global_sigs, export_table_sigs, export_func_sigs;
     for (const auto &tuple: import_funcs) import_func_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, true);
+    for (const auto &tuple: import_globals) import_global_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, true);
+    for (const auto &tuple: import_tables) import_table_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, true);
     for (const auto &tuple: export_globals) export_global_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, false);
+    for (const auto &tuple: export_tables) export_table_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, false);
     for (const auto &tuple: export_funcs) export_func_sigs[tuple.first] = get_extern_signature(module, tuple.second.index, false);
 
     // Module info dictionary
     Dictionary dict;
     dict["import_functions"] = import_func_sigs;
+    dict["import_globals"] = import_global_sigs;
+    dict["import_tables"] = import_table_sigs;
     dict["export_globals"] = export_global_sigs;
+    dict["export_tables"] = export_table_sigs;
     dict["export_functions"] = export_func_sigs;
     dict["memory"] = memory != NULL && memory->get_memory() ? memory->inspect() : get_memory_limits(module, memory_context);
     return dict;
@@ -379,9 +1302,6 @@ namespace godot {
     FAIL_IF(!export_globals.count(name), "Unknown global name " + name, NULL_VARIANT);
 
     // Retrieve exported global
-    wasm_extern_vec_t exports;
-    DEFER(wasm_extern_vec_delete(&exports));
-    wasm_instance_exports(instance, &exports);
     wasm_extern_t* data = exports.data[export_globals.at(name).index];
     const wasm_global_t* global = wasm_extern_as_global(data);
     FAIL_IF(global == NULL, "Failed to retrieve global export " + name, NULL_VARIANT);
@@ -392,25 +1312,130 @@ namespace godot {
     return decode_variant(result);
   }
 
-  Variant Wasm::function(String name, Array args) const {
+  godot_error Wasm::set_global(String name, Variant value) {
+    // Validate instance and global name
+    FAIL_IF(instance == NULL, "Not instantiated", ERR_UNCONFIGURED);
+    FAIL_IF(!export_globals.count(name), "Unknown global name " + name, ERR_INVALID_PARAMETER);
+
+    // Retrieve exported global and its type
+    wasm_global_t* global = wasm_extern_as_global(exports.data[export_globals.at(name).index]);
+    FAIL_IF(global == NULL, "Failed to retrieve global export " + name, ERR_INVALID_DATA);
+    wasm_globaltype_t* type = wasm_global_type(global);
+    DEFER(wasm_globaltype_delete(type));
+    FAIL_IF(wasm_globaltype_mutability(type) != WASM_VAR, "Immutable global " + name, ERR_UNAVAILABLE);
+
+    // Encode as declared kind
+    const wasm_valkind_t kind = wasm_valtype_kind(wasm_globaltype_content(type));
+    const wasm_val_t encoded = encode_variant(value, kind);
+    FAIL_IF(encoded.kind != kind, "Invalid value for global " + name, ERR_INVALID_PARAMETER);
+    wasm_global_set(global, &encoded);
+    return OK;
+  }
+
+  Variant Wasm::function(String name, Array args) {
     // Validate instance and function name
     FAIL_IF(instance == NULL, "Not instantiated", NULL_VARIANT);
+    if (tier_context != NULL && tier_context->ready && call_depth == 0) swap_tier(); // Safe point
+    FAIL_IF(instance == NULL, "Not instantiated", NULL_VARIANT);
+    call_depth++; // Includes allocator calls and import callbacks
+    DEFER(end_call());
     FAIL_IF(!export_funcs.count(name), "Unknown function name " + name, NULL_VARIANT);
 
     // Retrieve exported function
-    wasm_extern_vec_t exports;
-    DEFER(wasm_extern_vec_delete(&exports));
-    wasm_instance_exports(instance, &exports);
-    godot_wasm::context_func_export context = export_funcs.at(name);
+    godot_wasm::context_func_export& context = export_funcs.at(name);
     wasm_extern_t* data = exports.data[context.index];
     const wasm_func_t* func = wasm_extern_as_func(data);
     FAIL_IF(func == NULL, "Failed to retrieve function export " + name, NULL_VARIANT);
+    return call(func, context, name, args);
+  }
+
+  Variant Wasm::call_indirect(String table, uint32_t index, Array args) {
+    // Call function referenced by table element; dispatch by index avoids name lookup
+    FAIL_IF(instance == NULL, "Not instantiated", NULL_VARIANT);
+    if (tier_context != NULL && tier_context->ready && call_depth == 0) swap_tier(); // Safe point
+    FAIL_IF(instance == NULL, "Not instantiated", NULL_VARIANT);
+    call_depth++;
+    DEFER(end_call());
+    FAIL_IF(!export_tables.count(table), "Unknown table name " + table, NULL_VARIANT);
+    #ifdef WASMER
+      FAIL("Table elements unsupported by Wasmer C API", NULL_VARIANT);
+    #else
+      const wasm_table_t* data = wasm_extern_as_table(exports.data[export_tables.at(table).index]);
+      FAIL_IF(data == NULL, "Failed to retrieve table export " + table, NULL_VARIANT);
+      FAIL_IF(index >= wasm_table_size(data), "Table index out of bounds", NULL_VARIANT);
+      wasm_ref_t* ref = wasm_table_get(data, index);
+      DEFER(if (ref != NULL) wasm_ref_delete(ref));
+      const wasm_func_t* func = ref == NULL ? NULL : wasm_ref_as_func(ref);
+      FAIL_IF(func == NULL, "Null function reference", NULL_VARIANT);
+
+      // Signature of referenced function; statistics are not reported
+      wasm_functype_t* type = wasm_func_type(func);
+      DEFER(wasm_functype_delete(type));
+      const wasm_valtype_vec_t* func_params = wasm_functype_params(type);
+      const wasm_valtype_vec_t* func_results = wasm_functype_results(type);
+      std::string key; // Parameter and result kinds; short enough to avoid allocation in most cases
+      for (uint16_t i = 0; i < func_params->size; i++) key.push_back((char)wasm_valtype_kind(func_params->data[i]));
+      key.push_back(':');
+      for (uint16_t i = 0; i < func_results->size; i++) key.push_back((char)wasm_valtype_kind(func_results->data[i]));
+
+      // Reuse context of previous calls via this table with the same function type
+      auto &signatures = export_tables.at(table).signatures;
+      auto it = signatures.find(key);
+      if (it == signatures.end()) {
+        std::vector<wasm_valkind_t> params;
+        for (uint16_t i = 0; i < func_params->size; i++) params.push_back(wasm_valtype_kind(func_params->data[i]));
+        it = signatures.emplace(key, godot_wasm::context_func_export(0, table, func_results->size, params)).first;
+      }
+      return call(func, it->second, table, args);
+    #endif
+  }
+
+  void Wasm::end_call() {
+    if (--call_depth == 0 && !instrumentation->stopped.empty()) instrumentation->release_stopped();
+  }
+
+  Variant Wasm::call(const wasm_func_t* func, godot_wasm::context_func_export &context, const String &name, Array args) {
+    // Expand declared math types into scalar arguments
+    if (!context.signature.params.empty()) {
+      args = flatten_values(args, context.signature.params);
+      FAIL_IF((size_t)args.size() != context.params.size(), "Invalid arguments for function " + name, NULL_VARIANT);
+    }
+
+    // Reserve scratch memory for structured arguments; released on return
+    size_t marshalled = 0;
+    std::vector<size_t> sizes; // Sizes and encoded strings of structured arguments; empty if none
+    std::vector<CharString> strings;
+    for (uint16_t i = 0; i < args.size(); i++) {
+      if (!godot_wasm::is_marshalled(args[i].get_type())) continue;
+      if (sizes.empty()) {
+        sizes.resize(args.size());
+        strings.resize(args.size());
+      }
+      sizes[i] = align_marshalled(godot_wasm::marshal_size(args[i], strings[i]));
+      marshalled += sizes[i];
+    }
+    const uint32_t used = scratch_context->used;
+    DEFER(scratch_context->used = used);
+    if (marshalled > 0) {
+      FAIL_IF(memory.is_null() || memory->get_memory() == NULL, "Invalid memory", NULL_VARIANT);
+      FAIL_IF(reserve_scratch(marshalled), "Failed to reserve scratch memory", NULL_VARIANT);
+      FAIL_IF((size_t)scratch_context->offset + scratch_context->capacity > wasm_memory_data_size(memory->get_memory()), "Scratch memory out of bounds", NULL_VARIANT);
+    }
 
-    // Construct args
+    // Construct args; structured arguments are copied to scratch memory and passed as pointer and length
     std::vector<wasm_val_t> args_vec;
     for (uint16_t i = 0; i < args.size(); i++) {
       Variant variant = args[i];
-      wasm_val_t value = encode_variant(variant);
+      if (godot_wasm::is_marshalled(variant.get_type())) {
+        FAIL_IF(args_vec.size() + 2 > context.params.size(), "Invalid argument count", NULL_VARIANT);
+        uint32_t offset = scratch_context->offset + scratch_context->used;
+        uint32_t length = godot_wasm::marshal(variant, strings[i], wasm_memory_data(memory->get_memory()) + offset);
+        scratch_context->used += sizes[i];
+        args_vec.push_back(encode_variant(Variant((int64_t)offset), context.params[args_vec.size()]));
+        args_vec.push_back(encode_variant(Variant((int64_t)length), context.params[args_vec.size()]));
+        continue;
+      }
+      wasm_val_t value = args_vec.size() < context.params.size() ? encode_variant(variant, context.params[args_vec.size()]) : encode_variant(variant);
       FAIL_IF(value.kind == WASM_ANYREF, "Invalid argument type", NULL_VARIANT);
       args_vec.push_back(value);
     }
@@ -421,16 +1446,50 @@ namespace godot {
     wasm_val_vec_t f_results = { results_vec.size(), results_vec.data() };
 
     // Call function
-    FAIL_IF(wasm_func_call(func, &f_args, &f_results), "Failed calling function " + name, NULL_VARIANT);
+    godot_wasm::Profiler* profiler = instrumentation->profiler;
+    if (profiler) profiler->push(name);
+    TRACE_SCOPE(context.trace_name);
+    const uint64_t start = instrumentation->stats ? TIME_PRECISE : 0;
+    wasm_trap_t* trap = wasm_func_call(func, &f_args, &f_results);
+    if (instrumentation->stats) context.stats.record(TIME_PRECISE - start);
+    if (instrumentation->memory) instrumentation->memory->check_growth();
+    if (profiler) {
+      if (trap) profiler->record_trap(trap, function_names);
+      profiler->pop();
+    }
+    FAIL_IF(trap, "Failed calling function " + name, NULL_VARIANT);
 
     // Extract result(s)
     if (context.return_count == 0) return NULL_VARIANT;
-    if (context.return_count == 1) return decode_variant(results_vec[0]);
+    if (context.return_count == 1 && context.signature.results.empty()) return decode_variant(results_vec[0]);
     Array results = Array();
     for (uint16_t i = 0; i < context.return_count; i++) results.append(decode_variant(results_vec[i]));
+    results = collapse_values(results, context.signature.results); // Collapse declared math types
+    if (results.size() == 1) return results[0];
     return results;
   }
 
+  Variant Wasm::function_typed(String name, Array args, int32_t type) {
+    // Call function returning either pointer and length or a bare pointer to a structured value in memory
+    FAIL_IF(!godot_wasm::is_marshalled((Variant::Type)type), "Unsupported result type", NULL_VARIANT);
+    Variant result = function(name, args);
+    FAIL_IF(memory.is_null() || memory->get_memory() == NULL, "Invalid memory", NULL_VARIANT);
+    const byte_t* data = wasm_memory_data(memory->get_memory());
+    const size_t size = wasm_memory_data_size(memory->get_memory());
+    uint32_t offset, length = 0;
+    if (result.get_type() == Variant::ARRAY && ((Array)result).size() == 2) {
+      Array pair = result;
+      offset = (uint32_t)(int64_t)pair[0];
+      length = (uint32_t)(int64_t)pair[1];
+    } else if (result.get_type() == Variant::INT) {
+      FAIL_IF(godot_wasm::is_marshalled_array((Variant::Type)type), "Array result requires length", NULL_VARIANT);
+      offset = (uint32_t)(int64_t)result;
+      if (type == Variant::STRING || type == Variant::STRING_NAME) length = strnlen((const char*)data + MIN((size_t)offset, size), size - MIN((size_t)offset, size)); // Null terminated
+    } else FAIL("Invalid structured result of function " + name, NULL_VARIANT);
+    FAIL_IF(offset > size, "Result out of bounds", NULL_VARIANT);
+    return godot_wasm::unmarshal((Variant::Type)type, data + offset, length, size - offset);
+  }
+
   godot_error Wasm::map_names() {
     // Module imports
     wasm_importtype_vec_t imports;
@@ -441,12 +1500,22 @@ namespace godot {
       const wasm_externkind_t kind = wasm_externtype_kind(type);
       const String key = decode_name(wasm_importtype_module(imports.data[i])) + "." + decode_name(wasm_importtype_name(imports.data[i]));
       switch (kind) {
-        case WASM_EXTERN_FUNC:
-          import_funcs.emplace(key, godot_wasm::context_func_import(i));
+        case WASM_EXTERN_FUNC: {
+          const wasm_functype_t* func_type = wasm_externtype_as_functype((wasm_externtype_t*)type);
+          const wasm_valtype_vec_t* func_results = wasm_functype_results(func_type);
+          std::vector<wasm_valkind_t> results;
+          for (uint16_t j = 0; j < func_results->size; j++) results.push_back(wasm_valtype_kind(func_results->data[j]));
+          import_funcs.emplace(key, godot_wasm::context_func_import(i, key, results));
           break;
-        case WASM_EXTERN_MEMORY:
+        } case WASM_EXTERN_MEMORY:
           memory_context = new godot_wasm::context_memory(i, true);
           break;
+        case WASM_EXTERN_GLOBAL:
+          import_globals.emplace(key, godot_wasm::context_extern(i));
+          break;
+        case WASM_EXTERN_TABLE:
+          import_tables.emplace(key, godot_wasm::context_extern(i));
+          break;
         default: FAIL("Import type not implemented", ERR_INVALID_DATA);
       }
     }
@@ -462,8 +1531,11 @@ namespace godot {
       switch (kind) {
         case WASM_EXTERN_FUNC: {
           const wasm_functype_t* func_type = wasm_externtype_as_functype((wasm_externtype_t*)type);
+          const wasm_valtype_vec_t* func_params = wasm_functype_params(func_type);
           const wasm_valtype_vec_t* func_results = wasm_functype_results(func_type);
-          export_funcs.emplace(key, godot_wasm::context_func_export(i, func_results->size));
+          std::vector<wasm_valkind_t> params;
+          for (uint16_t j = 0; j < func_params->size; j++) params.push_back(wasm_valtype_kind(func_params->data[j]));
+          export_funcs.emplace(key, godot_wasm::context_func_export(i, key, func_results->size, params));
           break;
         } case WASM_EXTERN_GLOBAL:
           export_globals.emplace(key, godot_wasm::context_extern(i));
@@ -471,6 +1543,9 @@ namespace godot {
         case WASM_EXTERN_MEMORY:
           if (memory_context == NULL) memory_context = new godot_wasm::context_memory(i, false); // Favour import memory
           break;
+        case WASM_EXTERN_TABLE:
+          export_tables.emplace(key, godot_wasm::context_table(i));
+          break;
         default: FAIL("Export type not implemented", ERR_INVALID_DATA);
       }
     }
@@ -484,6 +1559,6 @@ namespace godot {
     wasm_module_imports(module, &imports);
     const wasm_externtype_t* type = wasm_importtype_type(imports.data[context->index]);
     const wasm_functype_t* func_type = wasm_externtype_as_functype((wasm_externtype_t*)type);
-    return wasm_func_new_with_env(STORE, func_type, callback_wrapper, context, NULL);
+    return wasm_func_new_with_env(store, func_type, callback_wrapper, context, NULL);
   }
 }
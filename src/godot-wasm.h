@@ -2,33 +2,77 @@
 #define GODOT_WASM_H
 
 #include <map>
+#include <atomic>
 #include "wasm.h"
 #include "defs.h"
 #include "wasm-memory.h"
+#include "wasm-framebuffer.h"
+#include "wasm-module.h"
 
 namespace godot {
   namespace godot_wasm {
     struct context_extern;
     struct context_func_import;
     struct context_func_export;
+    struct context_table;
     struct context_memory;
+    struct context_scratch;
+    struct context_stats;
+    struct context_instrumentation;
+    struct context_tier;
+    struct context_output;
+    class WasiFilesystem;
+    class WasiRandom;
   }
 
   class Wasm : public RefCounted {
     GDCLASS(Wasm, RefCounted);
 
     private:
+      wasm_store_t* store;
       wasm_module_t* module;
+      Ref<WasmModule> module_resource; // Owns module if compiled from resource
       wasm_instance_t* instance;
+      wasm_extern_vec_t exports;
       godot_wasm::context_memory* memory_context;
+      godot_wasm::context_scratch* scratch_context;
+      String allocator;
+      godot_wasm::context_instrumentation* instrumentation;
+      godot_wasm::context_tier* tier_context; // Background optimized compilation of baseline module
+      bool tiered;
+      uint32_t call_depth; // Nested export calls; instance may only be replaced at depth zero
+      bool deterministic;
+      int64_t virtual_clock; // Nanoseconds reported by WASI clocks in deterministic mode
+      godot_wasm::context_output* output_contexts[2]; // Buffered WASI stdout and stderr
+      std::atomic<bool> output_queued;
+      godot_wasm::WasiFilesystem* filesystem; // WASI file descriptors and preopened directories
+      godot_wasm::WasiRandom* random; // WASI entropy pool or seeded generator
+      std::map<uint32_t, String> function_names; // From name section
+      PackedStringArray monitors;
       Dictionary permissions;
       Ref<WasmMemory> memory;
+      Ref<WasmFramebuffer> framebuffer;
+      Array linked; // Instances providing linked imports; retained while their exports are in use
       std::map<String, godot_wasm::context_func_import> import_funcs;
+      std::map<String, godot_wasm::context_extern> import_globals;
+      std::map<String, godot_wasm::context_extern> import_tables;
       std::map<String, godot_wasm::context_extern> export_globals;
+      std::map<String, godot_wasm::context_table> export_tables;
       std::map<String, godot_wasm::context_func_export> export_funcs;
       void reset_instance();
+      void reset_module();
       godot_error map_names();
+      const wasm_extern_t* find_export(const String &name) const;
       wasm_func_t* create_callback(godot_wasm::context_func_import* context);
+      Variant call(const wasm_func_t* func, godot_wasm::context_func_export &context, const String &name, Array args);
+      void end_call();
+      godot_error reserve_scratch(size_t size);
+      void release_scratch();
+      godot_error compile_bytes(const wasm_byte_vec_t* bytes);
+      godot_error compile_tiered(const wasm_byte_vec_t* bytes);
+      godot_error create_instance(const Dictionary &import_map);
+      godot_error swap_tier();
+      const godot_wasm::context_stats* find_stats(const String &kind, const String &name) const;
 
     public:
       static void REGISTRATION_METHOD();
@@ -36,13 +80,54 @@ namespace godot {
       ~Wasm();
       void _init();
       void exit(int32_t code);
+      void write_output(int32_t fd, const char* data, size_t length);
+      void flush_output(bool partial);
+      godot_error redirect_output(int32_t fd, const String &sink, const String &path);
+      void isolate();
       godot_error compile(PackedByteArray bytecode);
       godot_error instantiate(const Dictionary import_map);
       godot_error load(PackedByteArray bytecode, const Dictionary import_map);
+      godot_error compile_file(String path);
+      godot_error load_file(String path, const Dictionary import_map);
+      godot_error compile_module(Ref<WasmModule> resource);
+      godot_error load_module(Ref<WasmModule> resource, const Dictionary import_map);
       Dictionary inspect() const;
-      Variant function(String name, Array args) const;
+      Variant function(String name, Array args);
+      Variant function_typed(String name, Array args, int32_t type);
       Variant global(String name) const;
+      godot_error set_global(String name, Variant value);
+      Variant call_indirect(String table, uint32_t index, Array args);
+      const wasm_func_t* get_export_function(const String &name) const;
       Ref<WasmMemory> get_memory() const;
+      void set_allocator(const String &name);
+      String get_allocator() const;
+      godot_error set_scratch(uint32_t offset, uint32_t size);
+      Ref<WasmFramebuffer> get_framebuffer() const;
+      godot_wasm::WasiFilesystem* get_filesystem() const;
+      godot_wasm::WasiRandom* get_random() const;
+      void seed_random(int64_t seed);
+      void unseed_random();
+      bool is_random_seeded() const;
+      void set_tiered(bool enabled);
+      bool is_tiered() const;
+      bool is_optimized() const;
+      void set_deterministic(bool enabled);
+      bool is_deterministic() const;
+      void set_virtual_clock(int64_t nsec);
+      int64_t get_virtual_clock() const;
+      int64_t get_state_hash() const;
+      void set_stats_enabled(bool enabled);
+      bool is_stats_enabled() const;
+      Dictionary get_stats() const;
+      Variant get_stat(const String &kind, const String &name, const String &field) const;
+      void reset_stats();
+      void add_monitors(const String &prefix);
+      void remove_monitors();
+      godot_error start_profiling(int32_t frequency);
+      String stop_profiling();
+      static void start_tracing();
+      static void stop_tracing();
+      static godot_error dump_trace(const String &path);
       void set_permissions(const Dictionary &update);
       Dictionary get_permissions() const;
       bool has_permission(String permission) const;
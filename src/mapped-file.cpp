@@ -0,0 +1,97 @@
+#include "mapped-file.h"
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#define FILE_CHUNK_SIZE 1048576 // Bytes read per call when streaming files
+
+namespace godot {
+  namespace godot_wasm {
+    MappedFile::MappedFile() {
+      data = NULL;
+      size = 0;
+      #ifdef _WIN32
+        mapping = NULL;
+      #endif
+    }
+
+    MappedFile::~MappedFile() {
+      close();
+    }
+
+    godot_error MappedFile::open(const String &path) {
+      // Only files on the host filesystem can be mapped; resources packed in a PCK cannot
+      close();
+      String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+      #ifdef _WIN32
+        HANDLE file = CreateFileW((LPCWSTR)global_path.utf16().get_data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return ERR_FILE_CANT_OPEN;
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+          CloseHandle(file);
+          return ERR_FILE_CANT_OPEN;
+        }
+        mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file); // Mapping retains file
+        if (mapping == NULL) return ERR_FILE_CANT_OPEN;
+        data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == NULL) {
+          close();
+          return ERR_FILE_CANT_OPEN;
+        }
+        size = (size_t)length.QuadPart;
+      #else
+        int fd = ::open(global_path.utf8().get_data(), O_RDONLY);
+        if (fd < 0) return ERR_FILE_CANT_OPEN;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+          ::close(fd);
+          return ERR_FILE_CANT_OPEN;
+        }
+        void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // Mapping retains file
+        if (mapped == MAP_FAILED) return ERR_FILE_CANT_OPEN;
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL); // Read once by compiler
+        data = (uint8_t*)mapped;
+        size = info.st_size;
+      #endif
+      return OK;
+    }
+
+    void MappedFile::close() {
+      #ifdef _WIN32
+        if (data != NULL) UnmapViewOfFile(data);
+        if (mapping != NULL) CloseHandle(mapping);
+        mapping = NULL;
+      #else
+        if (data != NULL) munmap(data, size);
+      #endif
+      data = NULL;
+      size = 0;
+    }
+
+    uint64_t read_file(Ref<FileAccess> file, uint8_t* dest, uint64_t length) {
+      // Read directly into destination, or in bounded chunks where the API only returns byte arrays
+      #ifdef GODOT_MODULE
+        return file->get_buffer(dest, length);
+      #else
+        uint64_t read = 0;
+        while (read < length) {
+          PackedByteArray chunk = file->get_buffer(MIN(length - read, (uint64_t)FILE_CHUNK_SIZE));
+          if (chunk.is_empty()) break;
+          memcpy(dest + read, chunk.ptr(), chunk.size());
+          read += chunk.size();
+        }
+        return read;
+      #endif
+    }
+  }
+}
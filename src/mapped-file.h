@@ -0,0 +1,32 @@
+#ifndef GODOT_WASM_MAPPED_FILE_H
+#define GODOT_WASM_MAPPED_FILE_H
+
+#include "defs.h"
+
+namespace godot {
+  namespace godot_wasm {
+    // Read-only memory mapping of a file on the host filesystem
+    class MappedFile {
+      private:
+        uint8_t* data;
+        size_t size;
+        #ifdef _WIN32
+          void* mapping;
+        #endif
+
+      public:
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator = (const MappedFile &) = delete;
+        godot_error open(const String &path);
+        void close();
+        const uint8_t* get_data() const { return data; }
+        size_t get_size() const { return size; }
+    };
+
+    uint64_t read_file(Ref<FileAccess> file, uint8_t* dest, uint64_t length);
+  }
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "marshal.h"
+
+// Packed arrays copied element-wise: (Variant type, class)
+#define MARSHALLED_ARRAYS(X) \
+  X(PACKED_BYTE_ARRAY, PackedByteArray) \
+  X(PACKED_INT32_ARRAY, PackedInt32Array) \
+  X(PACKED_INT64_ARRAY, PackedInt64Array) \
+  X(PACKED_FLOAT32_ARRAY, PackedFloat32Array) \
+  X(PACKED_FLOAT64_ARRAY, PackedFloat64Array) \
+  X(PACKED_VECTOR2_ARRAY, PackedVector2Array) \
+  X(PACKED_VECTOR3_ARRAY, PackedVector3Array) \
+  X(PACKED_COLOR_ARRAY, PackedColorArray)
+
+// Math types copied as-is: (Variant type, class, component count, component type)
+#define MARSHALLED_VALUES(X) \
+  X(VECTOR2, Vector2, 2, real_t) \
+  X(VECTOR2I, Vector2i, 2, int32_t) \
+  X(VECTOR3, Vector3, 3, real_t) \
+  X(VECTOR3I, Vector3i, 3, int32_t) \
+  X(VECTOR4, Vector4, 4, real_t) \
+  X(VECTOR4I, Vector4i, 4, int32_t) \
+  X(RECT2, Rect2, 4, real_t) \
+  X(RECT2I, Rect2i, 4, int32_t) \
+  X(QUATERNION, Quaternion, 4, real_t) \
+  X(COLOR, Color, 4, float) \
+  X(PLANE, Plane, 4, real_t) \
+  X(TRANSFORM2D, Transform2D, 6, real_t) \
+  X(BASIS, Basis, 9, real_t) \
+  X(TRANSFORM3D, Transform3D, 12, real_t) \
+  X(PROJECTION, Projection, 16, real_t)
+
+#define CASE_ARRAY(t, T) case Variant::t:
+#define CASE_VALUE(t, T, n, C) case Variant::t:
+
+#define ASSERT_VALUE(t, T, n, C) static_assert(sizeof(T) == n * sizeof(C), "Unexpected layout of " #T);
+MARSHALLED_VALUES(ASSERT_VALUE)
+
+namespace godot {
+  namespace godot_wasm {
+    bool is_marshalled(Variant::Type type) {
+      switch (type) {
+        case Variant::STRING: case Variant::STRING_NAME:
+        MARSHALLED_ARRAYS(CASE_ARRAY)
+        MARSHALLED_VALUES(CASE_VALUE)
+          return true;
+        default: return false;
+      }
+    }
+
+    bool is_marshalled_array(Variant::Type type) {
+      switch (type) {
+        MARSHALLED_ARRAYS(CASE_ARRAY)
+          return true;
+        default: return false;
+      }
+    }
+
+    size_t marshal_size(const Variant &variant, CharString &utf8) {
+      switch (variant.get_type()) {
+        case Variant::STRING: case Variant::STRING_NAME:
+          utf8 = String(variant).utf8();
+          return utf8.length() + 1; // Null terminated
+        #define SIZE_ARRAY(t, T) case Variant::t: { T a = variant; return a.size() * sizeof(*a.ptr()); }
+        MARSHALLED_ARRAYS(SIZE_ARRAY)
+        #define SIZE_VALUE(t, T, n, C) case Variant::t: return sizeof(T);
+        MARSHALLED_VALUES(SIZE_VALUE)
+        default: return 0;
+      }
+    }
+
+    uint32_t marshal(const Variant &variant, const CharString &utf8, byte_t* dest) {
+      // Destination must have at least marshal_size bytes available
+      switch (variant.get_type()) {
+        case Variant::STRING: case Variant::STRING_NAME:
+          memcpy(dest, utf8.get_data(), utf8.length() + 1);
+          return utf8.length();
+        #define MARSHAL_ARRAY(t, T) case Variant::t: { T a = variant; if (a.size()) memcpy(dest, a.ptr(), a.size() * sizeof(*a.ptr())); return a.size(); }
+        MARSHALLED_ARRAYS(MARSHAL_ARRAY)
+        #define MARSHAL_VALUE(t, T, n, C) case Variant::t: { T v = variant; memcpy(dest, &v, sizeof(T)); return n; }
+        MARSHALLED_VALUES(MARSHAL_VALUE)
+        default: FAIL("Unsupported marshalled type", 0);
+      }
+    }
+
+    Variant unmarshal(Variant::Type type, const byte_t* data, uint32_t length, size_t available) {
+      switch (type) {
+        case Variant::STRING:
+          FAIL_IF(length > available, "Marshalled value out of bounds", NULL_VARIANT);
+          return String::utf8((const char*)data, length);
+        case Variant::STRING_NAME:
+          FAIL_IF(length > available, "Marshalled value out of bounds", NULL_VARIANT);
+          return StringName(String::utf8((const char*)data, length));
+        #define UNMARSHAL_ARRAY(t, T) case Variant::t: { \
+          T a; \
+          FAIL_IF(length > available / sizeof(*a.ptr()), "Marshalled value out of bounds", NULL_VARIANT); \
+          a.resize(length); \
+          if (length) memcpy(a.ptrw(), data, length * sizeof(*a.ptr())); \
+          return a; \
+        }
+        MARSHALLED_ARRAYS(UNMARSHAL_ARRAY)
+        #define UNMARSHAL_VALUE(t, T, n, C) case Variant::t: { \
+          T v; \
+          FAIL_IF(sizeof(T) > available, "Marshalled value out of bounds", NULL_VARIANT); \
+          memcpy(&v, data, sizeof(T)); \
+          return v; \
+        }
+        MARSHALLED_VALUES(UNMARSHAL_VALUE)
+        default: FAIL("Unsupported marshalled type", NULL_VARIANT);
+      }
+    }
+
+    uint8_t flat_count(Variant::Type type) {
+      switch (type) {
+        case Variant::INT: case Variant::FLOAT: case Variant::BOOL: return 1;
+        #define COUNT_VALUE(t, T, n, C) case Variant::t: return n;
+        MARSHALLED_VALUES(COUNT_VALUE)
+        default: return 0;
+      }
+    }
+
+    void flatten(const Variant &variant, Array &scalars) {
+      switch (variant.get_type()) {
+        case Variant::INT: case Variant::FLOAT: case Variant::BOOL:
+          scalars.append(variant);
+          break;
+        #define FLATTEN_VALUE(t, T, n, C) case Variant::t: { \
+          T v = variant; \
+          const C* c = (const C*)&v; \
+          for (uint8_t i = 0; i < n; i++) scalars.append(c[i]); \
+          break; \
+        }
+        MARSHALLED_VALUES(FLATTEN_VALUE)
+        default: PRINT_ERROR("Unsupported flattened type");
+      }
+    }
+
+    Variant collapse(Variant::Type type, const Array &scalars, uint32_t index) {
+      // Scalars must have at least flat_count components from index
+      switch (type) {
+        case Variant::INT: return (int64_t)scalars[index];
+        case Variant::FLOAT: return (double)scalars[index];
+        case Variant::BOOL: return (bool)scalars[index];
+        #define COLLAPSE_VALUE(t, T, n, C) case Variant::t: { \
+          T v; \
+          C* c = (C*)&v; \
+          for (uint8_t i = 0; i < n; i++) c[i] = (C)(double)scalars[index + i]; \
+          return v; \
+        }
+        MARSHALLED_VALUES(COLLAPSE_VALUE)
+        default: FAIL("Unsupported flattened type", NULL_VARIANT);
+      }
+    }
+  }
+}
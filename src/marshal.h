@@ -0,0 +1,27 @@
+#ifndef GODOT_WASM_MARSHAL_H
+#define GODOT_WASM_MARSHAL_H
+
+#include "wasm.h"
+#include "defs.h"
+
+#define MARSHAL_ALIGN 8 // Alignment of values marshalled into linear memory
+
+namespace godot {
+  namespace godot_wasm {
+    // Variant types passed to and from Wasm modules via linear memory as pointer and length
+    // Length is in bytes for strings and byte arrays, in elements for other arrays, and in components for math types
+    bool is_marshalled(Variant::Type type);
+    bool is_marshalled_array(Variant::Type type);
+    // Strings are encoded to utf8 once by marshal_size and reused by marshal
+    size_t marshal_size(const Variant &variant, CharString &utf8);
+    uint32_t marshal(const Variant &variant, const CharString &utf8, byte_t* dest);
+    Variant unmarshal(Variant::Type type, const byte_t* data, uint32_t length, size_t available);
+
+    // Variant types passed to and from Wasm modules as consecutive scalar parameters or results
+    uint8_t flat_count(Variant::Type type);
+    void flatten(const Variant &variant, Array &scalars);
+    Variant collapse(Variant::Type type, const Array &scalars, uint32_t index);
+  }
+}
+
+#endif
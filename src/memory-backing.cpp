@@ -0,0 +1,112 @@
+#include <vector>
+#include "memory-backing.h"
+#include "mapped-file.h"
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#define HUGEPAGE_SIZE 2097152 // Transparent huge page size on x86-64 and arm64 Linux
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      size_t system_page_size() {
+        #ifdef _WIN32
+          SYSTEM_INFO info;
+          GetSystemInfo(&info);
+          return info.dwPageSize;
+        #else
+          return sysconf(_SC_PAGESIZE);
+        #endif
+      }
+
+      godot_error copy_file_region(uint8_t* dest, size_t length, const String &path, uint64_t offset) {
+        // Fallback for files packed in a PCK or platforms without private file mappings
+        Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+        FAIL_IF(file.is_null(), "Failed to open file " + path, ERR_FILE_CANT_OPEN);
+        FAIL_IF(offset + length > file->get_length(), "File region out of bounds", ERR_PARAMETER_RANGE_ERROR);
+        file->seek(offset);
+        FAIL_IF(read_file(file, dest, length) != length, "Failed to read file " + path, ERR_FILE_CANT_READ);
+        return OK;
+      }
+    }
+
+    godot_error advise_hugepages(uint8_t* data, size_t size, bool enabled) {
+      // Only whole huge pages within the range are eligible
+      #if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+        const uintptr_t start = ((uintptr_t)data + HUGEPAGE_SIZE - 1) & ~(uintptr_t)(HUGEPAGE_SIZE - 1);
+        const uintptr_t end = ((uintptr_t)data + size) & ~(uintptr_t)(HUGEPAGE_SIZE - 1);
+        if (end <= start) return OK;
+        FAIL_IF(madvise((void*)start, end - start, enabled ? MADV_HUGEPAGE : MADV_NOHUGEPAGE) != 0, "Failed to advise huge pages", FAILED);
+        return OK;
+      #else
+        FAIL("Transparent huge pages unsupported on this platform", ERR_UNAVAILABLE);
+      #endif
+    }
+
+    godot_error prefault(uint8_t* data, size_t size) {
+      // Populate pages up front rather than faulting on first touch by the module
+      const size_t page = system_page_size();
+      #ifdef MADV_POPULATE_WRITE
+        const uintptr_t start = (uintptr_t)data & ~(uintptr_t)(page - 1);
+        if (madvise((void*)start, (uintptr_t)data + size - start, MADV_POPULATE_WRITE) == 0) return OK;
+      #endif
+      // Touch each page; rewriting values in place is safe as modules run on the calling thread
+      for (size_t i = 0; i < size; i += page) {
+        volatile uint8_t* p = data + i;
+        *p = *p;
+      }
+      return OK;
+    }
+
+    godot_error map_file_region(uint8_t* dest, size_t length, const String &path, uint64_t offset) {
+      // Whole pages are mapped copy-on-write over linear memory and the remainder copied
+      #ifdef _WIN32
+        return copy_file_region(dest, length, path, offset); // Views can not replace committed pages
+      #else
+        const size_t page = system_page_size();
+        const size_t mapped = ((uintptr_t)dest % page == 0 && offset % page == 0) ? length - length % page : 0;
+        if (mapped > 0) {
+          const String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+          int fd = ::open(global_path.utf8().get_data(), O_RDONLY);
+          struct stat info;
+          if (fd >= 0 && fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && offset + length <= (uint64_t)info.st_size) {
+            void* result = mmap(dest, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, offset);
+            ::close(fd); // Mapping retains file
+            FAIL_IF(result == MAP_FAILED, "Failed to map file " + path, ERR_CANT_CREATE);
+            return length > mapped ? copy_file_region(dest + mapped, length - mapped, path, offset + mapped) : OK;
+          }
+          if (fd >= 0) ::close(fd);
+        }
+        return copy_file_region(dest, length, path, offset);
+      #endif
+    }
+
+    int64_t resident_size(const uint8_t* data, size_t size) {
+      #ifdef _WIN32
+        return -1; // Working set queries require psapi
+      #else
+        const size_t page = system_page_size();
+        const uintptr_t start = (uintptr_t)data & ~(uintptr_t)(page - 1);
+        const size_t pages = ((uintptr_t)data + size - start + page - 1) / page;
+        #ifdef __APPLE__
+          std::vector<char> residency(pages);
+        #else
+          std::vector<unsigned char> residency(pages);
+        #endif
+        FAIL_IF(mincore((void*)start, pages * page, residency.data()) != 0, "Failed to query resident pages", -1);
+        int64_t resident = 0;
+        for (size_t i = 0; i < pages; i++) if (residency[i] & 1) resident += page;
+        return resident;
+      #endif
+    }
+  }
+}
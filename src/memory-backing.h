@@ -0,0 +1,16 @@
+#ifndef GODOT_WASM_MEMORY_BACKING_H
+#define GODOT_WASM_MEMORY_BACKING_H
+
+#include "defs.h"
+
+namespace godot {
+  namespace godot_wasm {
+    // Operations on the host pages backing a linear memory; ranges must lie within the memory
+    godot_error advise_hugepages(uint8_t* data, size_t size, bool enabled);
+    godot_error prefault(uint8_t* data, size_t size);
+    godot_error map_file_region(uint8_t* dest, size_t length, const String &path, uint64_t offset);
+    int64_t resident_size(const uint8_t* data, size_t size);
+  }
+}
+
+#endif
@@ -3,24 +3,50 @@
 
 #include "wasm.h"
 
+#ifdef WASMER
+  #include "wasmer.h"
+#elif defined(WASMTIME)
+  #include "wasmtime.h"
+#endif
+#include "wasm-engine-config.h"
+
 #define STORE ::godot_wasm::Store::instance().store
 
 namespace godot_wasm {
   struct Store {
     private:
       Store() {
-        engine = wasm_engine_new();
+        engine = wasm_engine_new_with_config(godot::WasmEngineConfig::create_config());
         store = wasm_store_new(engine);
+        baseline_engine = new_baseline_engine();
       }
 
       ~Store() {
         wasm_store_delete(store);
         wasm_engine_delete(engine);
+        if (baseline_engine != NULL) wasm_engine_delete(baseline_engine);
+      }
+
+      static wasm_engine_t* new_baseline_engine() {
+        // Engine favouring compilation speed over code quality with otherwise configured features
+        #ifdef WASMER
+          if (!wasmer_is_compiler_available(SINGLEPASS)) return NULL;
+          wasm_config_t* config = godot::WasmEngineConfig::create_config();
+          wasm_config_set_compiler(config, SINGLEPASS);
+          return wasm_engine_new_with_config(config);
+        #elif defined(WASMTIME)
+          wasm_config_t* config = godot::WasmEngineConfig::create_config();
+          wasmtime_config_cranelift_opt_level_set(config, WASMTIME_OPT_LEVEL_NONE);
+          return wasm_engine_new_with_config(config);
+        #else
+          return NULL;
+        #endif
       }
 
     public:
       wasm_engine_t* engine;
       wasm_store_t* store;
+      wasm_engine_t* baseline_engine; // NULL if runtime lacks a baseline compiler
 
       static Store& instance() { // Public accessor
         static Store s;
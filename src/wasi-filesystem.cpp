@@ -0,0 +1,196 @@
+#include "wasi-filesystem.h"
+#include "wasi-shim.h"
+
+#define FD_PREOPEN_MIN 3 // Following stdin, stdout, and stderr
+#define FD_COUNT_MAX 1024 // Open descriptors per instance
+#define MMAP_SIZE_MIN 65536 // Files from this size are mapped rather than read via FileAccess
+#define DIRENT_SIZE 24 // Size of dirent header preceding each name
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      bool is_contained(const String &path) {
+        // Relative path must not escape its directory
+        if (path.is_absolute_path()) return false;
+        int32_t depth = 0;
+        const PackedStringArray parts = path.split("/", false);
+        for (auto i = 0; i < parts.size(); i++) {
+          if (parts[i] == "..") depth--;
+          else if (parts[i] != ".") depth++;
+          if (depth < 0) return false;
+        }
+        return true;
+      }
+
+      PackedStringArray list_entries(const String &path, int64_t &directory_count) {
+        // Directories followed by files, sorted such that cookies remain valid between calls
+        PackedStringArray entries = DirAccess::get_directories_at(path);
+        PackedStringArray files = DirAccess::get_files_at(path);
+        directory_count = entries.size();
+        entries.sort();
+        files.sort();
+        entries.append_array(files);
+        return entries;
+      }
+    }
+
+    WasiFilesystem::WasiFilesystem() {
+      next_fd = FD_PREOPEN_MIN;
+    }
+
+    WasiFilesystem::~WasiFilesystem() {
+      reset();
+    }
+
+    void WasiFilesystem::reset() {
+      for (auto &it: descriptors) if (it.second.mapped != NULL) delete it.second.mapped;
+      descriptors.clear();
+      next_fd = FD_PREOPEN_MIN;
+    }
+
+    const WasiFilesystem::descriptor* WasiFilesystem::find(int32_t fd) const {
+      auto it = descriptors.find(fd);
+      return it == descriptors.end() ? NULL : &it->second;
+    }
+
+    WasiFilesystem::descriptor* WasiFilesystem::find(int32_t fd) {
+      auto it = descriptors.find(fd);
+      return it == descriptors.end() ? NULL : &it->second;
+    }
+
+    godot_error WasiFilesystem::preopen(const String &guest, const String &path) {
+      FAIL_IF(!DirAccess::dir_exists_absolute(path), "Invalid preopen directory " + path, ERR_FILE_NOT_FOUND);
+      descriptors[next_fd++] = { path, guest, true, true, Ref<FileAccess>(), NULL, 0, 0 };
+      return OK;
+    }
+
+    uint16_t WasiFilesystem::prestat(int32_t fd, CharString &guest) const {
+      const descriptor* d = find(fd);
+      if (d == NULL || !d->preopen) return __WASI_ERRNO_BADF; // Guest enumerates preopens until BADF
+      guest = d->guest.utf8();
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    uint16_t WasiFilesystem::open(int32_t dirfd, const String &path, uint16_t oflags, uint64_t rights, uint16_t fdflags, int32_t &fd) {
+      const descriptor* dir = find(dirfd);
+      if (dir == NULL) return __WASI_ERRNO_BADF;
+      if (!dir->directory) return __WASI_ERRNO_NOTDIR;
+      if (!is_contained(path)) return __WASI_ERRNO_NOTCAPABLE;
+      if (oflags & (__WASI_OFLAGS_CREAT | __WASI_OFLAGS_EXCL | __WASI_OFLAGS_TRUNC)) return __WASI_ERRNO_ROFS;
+      if ((fdflags & __WASI_FDFLAGS_APPEND) || (rights & __WASI_RIGHTS_FD_WRITE)) return __WASI_ERRNO_ROFS;
+      if (descriptors.size() >= FD_COUNT_MAX) return __WASI_ERRNO_NFILE;
+
+      const String full_path = dir->path.path_join(path).simplify_path();
+      descriptor d = { full_path, "", false, false, Ref<FileAccess>(), NULL, 0, 0 };
+      if (DirAccess::dir_exists_absolute(full_path)) {
+        d.directory = true;
+      } else if (!FILE_EXISTS(full_path)) {
+        return __WASI_ERRNO_NOENT;
+      } else if (oflags & __WASI_OFLAGS_DIRECTORY) {
+        return __WASI_ERRNO_NOTDIR;
+      } else {
+        d.file = FileAccess::open(full_path, FileAccess::READ);
+        if (d.file.is_null()) return __WASI_ERRNO_ACCES;
+        d.size = d.file->get_length();
+        // Map large files on the host filesystem; resources packed in a PCK are read via FileAccess
+        if (d.size >= MMAP_SIZE_MIN) {
+          d.mapped = new MappedFile();
+          if (d.mapped->open(full_path) != OK || d.mapped->get_size() != d.size) {
+            delete d.mapped;
+            d.mapped = NULL;
+          }
+        }
+      }
+      fd = next_fd++;
+      descriptors[fd] = d;
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    uint16_t WasiFilesystem::close(int32_t fd) {
+      descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      if (d->mapped != NULL) delete d->mapped;
+      descriptors.erase(fd);
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    uint16_t WasiFilesystem::read(int32_t fd, uint8_t* dest, uint64_t length, uint64_t &read) {
+      descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      uint16_t err = pread(fd, dest, length, d->position, read);
+      d->position += read;
+      return err;
+    }
+
+    uint16_t WasiFilesystem::pread(int32_t fd, uint8_t* dest, uint64_t length, uint64_t offset, uint64_t &read) {
+      // Copied into destination directly from mapping or via FileAccess
+      read = 0;
+      descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      if (d->directory) return __WASI_ERRNO_ISDIR;
+      if (offset >= d->size) return __WASI_ERRNO_SUCCESS; // End of file
+      length = MIN(length, d->size - offset);
+      if (d->mapped != NULL) {
+        memcpy(dest, d->mapped->get_data() + offset, length);
+        read = length;
+        return __WASI_ERRNO_SUCCESS;
+      }
+      d->file->seek(offset);
+      read = read_file(d->file, dest, length);
+      return read == length ? __WASI_ERRNO_SUCCESS : __WASI_ERRNO_IO;
+    }
+
+    uint16_t WasiFilesystem::seek(int32_t fd, int64_t offset, uint8_t whence, uint64_t &position) {
+      descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      if (d->directory) return __WASI_ERRNO_ISDIR;
+      int64_t base;
+      switch (whence) {
+        case __WASI_WHENCE_SET: base = 0; break;
+        case __WASI_WHENCE_CUR: base = d->position; break;
+        case __WASI_WHENCE_END: base = d->size; break;
+        default: return __WASI_ERRNO_INVAL;
+      }
+      if (base + offset < 0) return __WASI_ERRNO_INVAL;
+      d->position = position = base + offset;
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    uint16_t WasiFilesystem::stat(int32_t fd, filestat &stat) const {
+      const descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      stat.filetype = d->directory ? __WASI_FILETYPE_DIRECTORY : __WASI_FILETYPE_REGULAR_FILE;
+      stat.size = d->size;
+      stat.modified = d->directory ? 0 : FileAccess::get_modified_time(d->path) * 1000000000;
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    uint16_t WasiFilesystem::readdir(int32_t fd, uint8_t* dest, uint32_t length, uint64_t cookie, uint32_t &used) const {
+      // Entries are truncated at end of buffer, which the guest treats as a signal to read again
+      used = 0;
+      const descriptor* d = find(fd);
+      if (d == NULL) return __WASI_ERRNO_BADF;
+      if (!d->directory) return __WASI_ERRNO_NOTDIR;
+      int64_t directories;
+      const PackedStringArray entries = list_entries(d->path, directories);
+      for (uint64_t i = cookie; i < (uint64_t)entries.size() && used < length; i++) {
+        const CharString name = entries[i].utf8();
+        uint8_t dirent[DIRENT_SIZE] = {};
+        const uint64_t next = i + 1;
+        const uint64_t inode = 0; // Not exposed by Godot
+        const uint32_t name_length = name.length();
+        memcpy(dirent, &next, sizeof(next));
+        memcpy(dirent + 8, &inode, sizeof(inode));
+        memcpy(dirent + 16, &name_length, sizeof(name_length));
+        dirent[20] = (int64_t)i < directories ? __WASI_FILETYPE_DIRECTORY : __WASI_FILETYPE_REGULAR_FILE;
+        const uint32_t header = MIN((uint32_t)DIRENT_SIZE, length - used);
+        memcpy(dest + used, dirent, header);
+        used += header;
+        const uint32_t name_size = MIN(name_length, length - used);
+        memcpy(dest + used, name.get_data(), name_size);
+        used += name_size;
+      }
+      return __WASI_ERRNO_SUCCESS;
+    }
+  }
+}
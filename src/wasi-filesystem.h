@@ -0,0 +1,70 @@
+#ifndef GODOT_WASM_WASI_FILESYSTEM_H
+#define GODOT_WASM_WASI_FILESYSTEM_H
+
+#include <map>
+#include "defs.h"
+#include "mapped-file.h"
+
+// See https://github.com/WebAssembly/WASI/blob/main/legacy/preview1/docs.md
+#define __WASI_FILETYPE_UNKNOWN (UINT8_C(0))
+#define __WASI_FILETYPE_CHARACTER_DEVICE (UINT8_C(2))
+#define __WASI_FILETYPE_DIRECTORY (UINT8_C(3))
+#define __WASI_FILETYPE_REGULAR_FILE (UINT8_C(4))
+#define __WASI_OFLAGS_CREAT (UINT16_C(1))
+#define __WASI_OFLAGS_DIRECTORY (UINT16_C(2))
+#define __WASI_OFLAGS_EXCL (UINT16_C(4))
+#define __WASI_OFLAGS_TRUNC (UINT16_C(8))
+#define __WASI_FDFLAGS_APPEND (UINT16_C(1))
+#define __WASI_RIGHTS_FD_WRITE (UINT64_C(64))
+#define __WASI_WHENCE_SET (UINT8_C(0))
+#define __WASI_WHENCE_CUR (UINT8_C(1))
+#define __WASI_WHENCE_END (UINT8_C(2))
+
+namespace godot {
+  namespace godot_wasm {
+    // Read-only file descriptors over Godot paths for the WASI shim
+    // Methods return WASI errno values rather than trapping so guests may handle missing files
+    class WasiFilesystem {
+      public:
+        struct filestat {
+          uint8_t filetype;
+          uint64_t size;
+          uint64_t modified; // Nanoseconds since epoch
+        };
+
+      private:
+        struct descriptor {
+          String path; // Godot path e.g. res://assets
+          String guest; // Guest path of preopened directories
+          bool directory;
+          bool preopen;
+          Ref<FileAccess> file;
+          MappedFile* mapped; // Large files read directly from mapping
+          uint64_t position;
+          uint64_t size;
+        };
+        std::map<int32_t, descriptor> descriptors;
+        int32_t next_fd;
+        const descriptor* find(int32_t fd) const;
+        descriptor* find(int32_t fd);
+
+      public:
+        WasiFilesystem();
+        ~WasiFilesystem();
+        WasiFilesystem(const WasiFilesystem &) = delete;
+        WasiFilesystem & operator = (const WasiFilesystem &) = delete;
+        void reset();
+        godot_error preopen(const String &guest, const String &path);
+        uint16_t prestat(int32_t fd, CharString &guest) const;
+        uint16_t open(int32_t dirfd, const String &path, uint16_t oflags, uint64_t rights, uint16_t fdflags, int32_t &fd);
+        uint16_t close(int32_t fd);
+        uint16_t read(int32_t fd, uint8_t* dest, uint64_t length, uint64_t &read);
+        uint16_t pread(int32_t fd, uint8_t* dest, uint64_t length, uint64_t offset, uint64_t &read);
+        uint16_t seek(int32_t fd, int64_t offset, uint8_t whence, uint64_t &position);
+        uint16_t stat(int32_t fd, filestat &stat) const;
+        uint16_t readdir(int32_t fd, uint8_t* dest, uint32_t length, uint64_t cookie, uint32_t &used) const;
+    };
+  }
+}
+
+#endif
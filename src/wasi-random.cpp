@@ -0,0 +1,93 @@
+#include "wasi-random.h"
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      uint64_t splitmix64(uint64_t &x) {
+        // Expands seed into generator state; see https://prng.di.unimi.it/splitmix64.c
+        uint64_t z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+      }
+
+      inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+      }
+    }
+
+    WasiRandom::WasiRandom() {
+      available = 0;
+      seeded = false;
+      seed_value = 0;
+      #ifdef GODOT_MODULE
+        initialized = false;
+      #endif
+      memset(state, 0, sizeof(state));
+    }
+
+    void WasiRandom::seed(uint64_t value) {
+      seed_value = value;
+      for (uint8_t i = 0; i < 4; i++) state[i] = splitmix64(value);
+      seeded = true;
+    }
+
+    void WasiRandom::unseed() {
+      seeded = false;
+    }
+
+    void WasiRandom::restart() {
+      // Seeded sequence begins anew such that replays reproduce from instantiation
+      if (seeded) seed(seed_value);
+    }
+
+    uint64_t WasiRandom::next() {
+      // See https://prng.di.unimi.it/xoshiro256starstar.c
+      const uint64_t result = rotl(state[1] * 5, 7) * 9;
+      const uint64_t t = state[1] << 17;
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = rotl(state[3], 45);
+      return result;
+    }
+
+    godot_error WasiRandom::refill() {
+      #ifdef GODOT_MODULE
+        if (!initialized && generator.init() != OK) return ERR_CANT_CREATE;
+        initialized = true;
+        godot_error err = generator.get_random_bytes(pool, RANDOM_POOL_SIZE);
+        if (err != OK) return err;
+      #else
+        if (crypto.is_null()) crypto.instantiate();
+        PackedByteArray bytes = crypto->generate_random_bytes(RANDOM_POOL_SIZE);
+        if (bytes.size() != RANDOM_POOL_SIZE) return ERR_CANT_CREATE;
+        memcpy(pool, bytes.ptr(), RANDOM_POOL_SIZE);
+      #endif
+      available = RANDOM_POOL_SIZE;
+      return OK;
+    }
+
+    godot_error WasiRandom::fill(uint8_t* dest, size_t length) {
+      if (seeded) {
+        // Bytes taken little-endian such that output is identical across hosts
+        for (size_t i = 0; i < length; i += 8) {
+          const uint64_t value = next();
+          for (size_t j = 0; j < 8 && i + j < length; j++) dest[i + j] = (uint8_t)(value >> (j * 8));
+        }
+        return OK;
+      }
+      while (length > 0) {
+        if (available == 0) FAIL_IF(refill() != OK, "Failed to gather entropy", ERR_CANT_CREATE);
+        const size_t n = MIN(length, available);
+        memcpy(dest, pool + RANDOM_POOL_SIZE - available, n);
+        available -= n;
+        dest += n;
+        length -= n;
+      }
+      return OK;
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef GODOT_WASM_WASI_RANDOM_H
+#define GODOT_WASM_WASI_RANDOM_H
+
+#include "defs.h"
+
+#define RANDOM_POOL_SIZE 4096 // Bytes of system entropy buffered per refill
+
+namespace godot {
+  namespace godot_wasm {
+    // Random bytes for the WASI shim from buffered system entropy or, once seeded, a deterministic generator
+    class WasiRandom {
+      private:
+        uint8_t pool[RANDOM_POOL_SIZE];
+        size_t available; // Unused bytes at end of pool
+        bool seeded;
+        uint64_t seed_value;
+        uint64_t state[4]; // xoshiro256** state
+        #ifdef GODOT_MODULE
+          CryptoCore::RandomGenerator generator;
+          bool initialized;
+        #else
+          Ref<Crypto> crypto;
+        #endif
+        godot_error refill();
+        uint64_t next();
+
+      public:
+        WasiRandom();
+        WasiRandom(const WasiRandom &) = delete;
+        WasiRandom & operator = (const WasiRandom &) = delete;
+        void seed(uint64_t value);
+        void unseed();
+        void restart();
+        bool is_seeded() const { return seeded; }
+        godot_error fill(uint8_t* dest, size_t length);
+    };
+  }
+}
+
+#endif
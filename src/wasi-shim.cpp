@@ -2,17 +2,20 @@
 #include <vector>
 #include <map>
 #include "wasi-shim.h"
+#include "wasi-filesystem.h"
+#include "wasi-random.h"
 #include "godot-wasm.h"
 #include "defer.h"
+#include "wasm-tracer.h"
 #include "wasmShimNode3d.h"
+#include "wasmShimPhysics3d.h"
 
 // See https://github.com/WebAssembly/wasi-libc/blob/main/libc-bottom-half/headers/public/wasi/api.h
 #define __WASI_CLOCKID_REALTIME (UINT32_C(0)) // The clock measuring real time
 #define __WASI_CLOCKID_MONOTONIC (UINT32_C(1)) // The store-wide monotonic clock
-#define __WASI_ERRNO_SUCCESS (UINT16_C(0)) // No error occurred
-#define __WASI_ERRNO_ACCES (UINT16_C(2)) // [sic] Permission denied
-#define __WASI_ERRNO_INVAL (UINT16_C(28)) // Invalid argument
-#define __WASI_ERRNO_IO (UINT16_C(29)) // I/O error
+#define __WASI_PREOPENTYPE_DIR (UINT8_C(0)) // A pre-opened directory
+#define __WASI_RIGHTS_READ_ONLY (UINT64_C(0x2460a6)) // Read, seek, tell, advise, path_open, readdir, and filestat rights
+#define __WASI_RIGHTS_STDIO (UINT64_C(0x42)) // Read and write rights
 
 namespace godot {
   namespace {
@@ -62,6 +65,37 @@ namespace godot {
       return encoded;
     }
 
+    bool in_bounds(wasm_memory_t* memory, uint64_t offset, uint64_t length) {
+      return offset + length <= wasm_memory_data_size(memory);
+    }
+
+    uint16_t read_io_vectors(Wasm* wasm, wasm_memory_t* memory, int32_t fd, int32_t offset_iov, int32_t count_iov, int64_t position, uint32_t &total) {
+      // Reads into guest memory directly; position is the current file position if negative
+      godot_wasm::WasiFilesystem* filesystem = wasm->get_filesystem();
+      byte_t* data = wasm_memory_data(memory);
+      total = 0;
+      if (!in_bounds(memory, (uint32_t)offset_iov, (uint64_t)(uint32_t)count_iov * sizeof(wasi_io_vector))) return __WASI_ERRNO_INVAL;
+      for (auto i = 0; i < count_iov; i++) {
+        wasi_io_vector iov = get_io_vector(memory, offset_iov, i);
+        if (!in_bounds(memory, (uint32_t)iov.offset, (uint32_t)iov.length)) return __WASI_ERRNO_INVAL;
+        uint64_t read = 0;
+        uint16_t err = position < 0
+          ? filesystem->read(fd, (uint8_t*)data + (uint32_t)iov.offset, (uint32_t)iov.length, read)
+          : filesystem->pread(fd, (uint8_t*)data + (uint32_t)iov.offset, (uint32_t)iov.length, position + total, read);
+        total += read;
+        if (err != __WASI_ERRNO_SUCCESS) return err;
+        if (read < (uint32_t)iov.length) break; // End of file
+      }
+      return __WASI_ERRNO_SUCCESS;
+    }
+
+    wasm_trap_t* wasi_errno(wasm_val_vec_t* results, uint16_t value) {
+      // Errors the guest is expected to handle e.g. missing files
+      results->data[0].kind = WASM_I32;
+      results->data[0].of.i32 = value;
+      return NULL;
+    }
+
     wasm_trap_t* wasi_result(wasm_val_vec_t* results, int32_t value = __WASI_ERRNO_SUCCESS, const char* message = nullptr) {
       results->data[0].kind = WASM_I32;
       results->data[0].of.i32 = value;
@@ -73,6 +107,7 @@ namespace godot {
 
     // WASI fd_write: [I32, I32, I32, I32] -> [I32]
     wasm_trap_t* wasi_fd_write(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 4 || results->size != 1, "Invalid arguments fd_write", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
@@ -86,9 +121,7 @@ namespace godot {
       uint32_t written = 0;
       for (auto i = 0; i < count_iov; i++) {
         wasi_io_vector iov = get_io_vector(memory, offset_iov, i);
-        std::string message = std::string(data + iov.offset, data + iov.offset + iov.length);
-        if (iov.length == 1 && message == "\u000A") continue; // Skip line feed
-        fd == 1 ? PRINT(message.c_str()) : PRINT_ERROR(message.c_str());
+        wasm->write_output(fd, (const char*)data + iov.offset, iov.length); // Line buffered
         written += iov.length;
       }
       memcpy(data + offset_written, &written, sizeof(int32_t));
@@ -97,6 +130,7 @@ namespace godot {
 
     // WASI proc_exit: [I32] -> []
     wasm_trap_t* wasi_proc_exit(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 1 || results->size != 0, "Invalid arguments proc_exit", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       if (!wasm->has_permission("exit")) return wasi_result(results, __WASI_ERRNO_ACCES, "Not permitted\0");
@@ -106,6 +140,7 @@ namespace godot {
 
     // WASI args_sizes_get: [I32, I32] -> [I32]
     wasm_trap_t* wasi_args_sizes_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments args_sizes_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
@@ -122,6 +157,7 @@ namespace godot {
 
     // WASI args_get: [I32, I32] -> [I32]
     wasm_trap_t* wasi_args_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments args_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
@@ -143,6 +179,7 @@ namespace godot {
 
     // WASI environ_sizes_get: [I32, I32] -> [I32]
     wasm_trap_t* wasi_environ_sizes_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments environ_sizes_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
@@ -158,27 +195,30 @@ namespace godot {
 
     // WASI environ_get: [I32, I32] -> [I32]
     wasm_trap_t* wasi_environ_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments environ_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       return wasi_result(results);
     }
 
     // WASI random_get: [I32, I32] -> [I32]
     wasm_trap_t* wasi_random_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments random_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
       if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
       if (!wasm->has_permission("random")) return wasi_result(results, __WASI_ERRNO_ACCES, "Not permitted\0");
+      uint32_t offset = args->data[0].of.i32;
+      uint32_t length = args->data[1].of.i32;
+      if (!in_bounds(memory, offset, length)) return wasi_result(results, __WASI_ERRNO_INVAL, "Invalid buffer\0");
       byte_t* data = wasm_memory_data(memory);
-      int32_t offset = args->data[0].of.i32;
-      int32_t length = args->data[1].of.i32;
-      PackedByteArray bytes = RANDOM_BYTES(length);
-      memcpy(data + offset, BYTE_ARRAY_POINTER(bytes), length);
+      if (wasm->get_random()->fill((uint8_t*)data + offset, length) != OK) return wasi_result(results, __WASI_ERRNO_IO, "Entropy unavailable\0");
       return wasi_result(results);
     }
 
     // WASI clock_time_get: [I32, I64, I32] -> [I32]
     wasm_trap_t* wasi_clock_time_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
       FAIL_IF(args->size != 3 || results->size != 1, "Invalid arguments clock_time_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
       Wasm* wasm = (Wasm*)env;
       wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
@@ -187,11 +227,235 @@ namespace godot {
       byte_t* data = wasm_memory_data(memory);
       int32_t clock_id = args->data[0].of.i32;
       int32_t offset = args->data[2].of.i32;
-      int64_t t = clock_id == __WASI_CLOCKID_REALTIME ? TIME_REALTIME : TIME_MONOTONIC;
+      int64_t t = wasm->is_deterministic() ? wasm->get_virtual_clock() : clock_id == __WASI_CLOCKID_REALTIME ? TIME_REALTIME : TIME_MONOTONIC;
       memcpy(data + offset, &t, sizeof(t));
       return wasi_result(results);
     }
 
+    // WASI fd_prestat_get: [I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_prestat_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments fd_prestat_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_BADF); // No preopens
+      int32_t fd = args->data[0].of.i32;
+      int32_t offset = args->data[1].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset, 8)) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      CharString guest;
+      uint16_t err = wasm->get_filesystem()->prestat(fd, guest);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      byte_t* data = wasm_memory_data(memory) + (uint32_t)offset;
+      uint32_t length = guest.length();
+      memset(data, 0, 8);
+      data[0] = __WASI_PREOPENTYPE_DIR;
+      memcpy(data + 4, &length, sizeof(length));
+      return wasi_result(results);
+    }
+
+    // WASI fd_prestat_dir_name: [I32, I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_prestat_dir_name(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 3 || results->size != 1, "Invalid arguments fd_prestat_dir_name", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_BADF);
+      int32_t fd = args->data[0].of.i32;
+      int32_t offset = args->data[1].of.i32;
+      uint32_t length = args->data[2].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset, length)) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      CharString guest;
+      uint16_t err = wasm->get_filesystem()->prestat(fd, guest);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(wasm_memory_data(memory) + (uint32_t)offset, guest.get_data(), MIN(length, (uint32_t)guest.length())); // Not null terminated
+      return wasi_result(results);
+    }
+
+    // WASI fd_fdstat_get: [I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_fdstat_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments fd_fdstat_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      int32_t fd = args->data[0].of.i32;
+      int32_t offset = args->data[1].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset, 24)) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      godot_wasm::WasiFilesystem::filestat stat = { __WASI_FILETYPE_CHARACTER_DEVICE, 0, 0 };
+      uint64_t rights = __WASI_RIGHTS_STDIO;
+      if (fd > 2) { // Standard streams are always present
+        if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_BADF);
+        uint16_t err = wasm->get_filesystem()->stat(fd, stat);
+        if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+        rights = __WASI_RIGHTS_READ_ONLY;
+      }
+      byte_t* data = wasm_memory_data(memory) + (uint32_t)offset;
+      memset(data, 0, 24);
+      data[0] = stat.filetype;
+      memcpy(data + 8, &rights, sizeof(rights)); // Base rights
+      memcpy(data + 16, &rights, sizeof(rights)); // Inheriting rights
+      return wasi_result(results);
+    }
+
+    // WASI path_open: [I32, I32, I32, I32, I32, I64, I64, I32, I32] -> [I32]
+    wasm_trap_t* wasi_path_open(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 9 || results->size != 1, "Invalid arguments path_open", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int32_t dirfd = args->data[0].of.i32;
+      int32_t offset_path = args->data[2].of.i32;
+      uint32_t length_path = args->data[3].of.i32;
+      uint16_t oflags = args->data[4].of.i32;
+      uint64_t rights = args->data[5].of.i64;
+      uint16_t fdflags = args->data[7].of.i32;
+      int32_t offset_fd = args->data[8].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset_path, length_path) || !in_bounds(memory, (uint32_t)offset_fd, sizeof(int32_t))) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      byte_t* data = wasm_memory_data(memory);
+      const String path = String::utf8((const char*)data + (uint32_t)offset_path, length_path);
+      int32_t fd;
+      uint16_t err = wasm->get_filesystem()->open(dirfd, path, oflags, rights, fdflags, fd);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(data + (uint32_t)offset_fd, &fd, sizeof(int32_t));
+      return wasi_result(results);
+    }
+
+    // WASI fd_read: [I32, I32, I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_read(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 4 || results->size != 1, "Invalid arguments fd_read", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int32_t offset_read = args->data[3].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset_read, sizeof(uint32_t))) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      uint32_t read;
+      uint16_t err = read_io_vectors(wasm, memory, args->data[0].of.i32, args->data[1].of.i32, args->data[2].of.i32, -1, read);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(wasm_memory_data(memory) + (uint32_t)offset_read, &read, sizeof(uint32_t));
+      return wasi_result(results);
+    }
+
+    // WASI fd_pread: [I32, I32, I32, I64, I32] -> [I32]
+    wasm_trap_t* wasi_fd_pread(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 5 || results->size != 1, "Invalid arguments fd_pread", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int64_t position = args->data[3].of.i64;
+      int32_t offset_read = args->data[4].of.i32;
+      if (position < 0) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      if (!in_bounds(memory, (uint32_t)offset_read, sizeof(uint32_t))) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      uint32_t read;
+      uint16_t err = read_io_vectors(wasm, memory, args->data[0].of.i32, args->data[1].of.i32, args->data[2].of.i32, position, read);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(wasm_memory_data(memory) + (uint32_t)offset_read, &read, sizeof(uint32_t));
+      return wasi_result(results);
+    }
+
+    // WASI fd_seek: [I32, I64, I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_seek(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 4 || results->size != 1, "Invalid arguments fd_seek", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int32_t offset_position = args->data[3].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset_position, sizeof(uint64_t))) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      uint64_t position;
+      uint16_t err = wasm->get_filesystem()->seek(args->data[0].of.i32, args->data[1].of.i64, args->data[2].of.i32, position);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(wasm_memory_data(memory) + (uint32_t)offset_position, &position, sizeof(uint64_t));
+      return wasi_result(results);
+    }
+
+    // WASI fd_close: [I32] -> [I32]
+    wasm_trap_t* wasi_fd_close(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 1 || results->size != 1, "Invalid arguments fd_close", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      return wasi_errno(results, wasm->get_filesystem()->close(args->data[0].of.i32));
+    }
+
+    // WASI fd_filestat_get: [I32, I32] -> [I32]
+    wasm_trap_t* wasi_fd_filestat_get(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 2 || results->size != 1, "Invalid arguments fd_filestat_get", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int32_t offset = args->data[1].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset, 64)) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      godot_wasm::WasiFilesystem::filestat stat;
+      uint16_t err = wasm->get_filesystem()->stat(args->data[0].of.i32, stat);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      byte_t* data = wasm_memory_data(memory) + (uint32_t)offset;
+      const uint64_t links = 1;
+      memset(data, 0, 64);
+      data[16] = stat.filetype;
+      memcpy(data + 24, &links, sizeof(uint64_t));
+      memcpy(data + 32, &stat.size, sizeof(uint64_t));
+      memcpy(data + 40, &stat.modified, sizeof(uint64_t)); // Access time
+      memcpy(data + 48, &stat.modified, sizeof(uint64_t)); // Modification time
+      memcpy(data + 56, &stat.modified, sizeof(uint64_t)); // Status change time
+      return wasi_result(results);
+    }
+
+    // WASI fd_readdir: [I32, I32, I32, I64, I32] -> [I32]
+    wasm_trap_t* wasi_fd_readdir(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 5 || results->size != 1, "Invalid arguments fd_readdir", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();
+      if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      if (!wasm->has_permission("filesystem")) return wasi_errno(results, __WASI_ERRNO_ACCES);
+      int32_t offset = args->data[1].of.i32;
+      uint32_t length = args->data[2].of.i32;
+      uint64_t cookie = args->data[3].of.i64;
+      int32_t offset_used = args->data[4].of.i32;
+      if (!in_bounds(memory, (uint32_t)offset, length) || !in_bounds(memory, (uint32_t)offset_used, sizeof(uint32_t))) return wasi_errno(results, __WASI_ERRNO_INVAL);
+      byte_t* data = wasm_memory_data(memory);
+      uint32_t used;
+      uint16_t err = wasm->get_filesystem()->readdir(args->data[0].of.i32, (uint8_t*)data + (uint32_t)offset, length, cookie, used);
+      if (err != __WASI_ERRNO_SUCCESS) return wasi_errno(results, err);
+      memcpy(data + (uint32_t)offset_used, &used, sizeof(uint32_t));
+      return wasi_result(results);
+    }
+
+    // Godot framebuffer_register: [I32, I32, I32] -> [I32]
+    wasm_trap_t* godot_framebuffer_register(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 3 || results->size != 1, "Invalid arguments framebuffer_register", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      if (wasm->get_memory().is_null()) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");
+      int32_t offset = args->data[0].of.i32;
+      int32_t width = args->data[1].of.i32;
+      int32_t height = args->data[2].of.i32;
+      godot_error error = wasm->get_framebuffer()->bind(wasm->get_memory(), offset, width, height);
+      if (error != OK) return wasi_result(results, __WASI_ERRNO_INVAL, "Invalid framebuffer\0");
+      return wasi_result(results);
+    }
+
+    // Godot framebuffer_dirty: [I32, I32, I32, I32] -> [I32]
+    wasm_trap_t* godot_framebuffer_dirty(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results) {
+      TRACE_SCOPE(__FUNCTION__);
+      FAIL_IF(args->size != 4 || results->size != 1, "Invalid arguments framebuffer_dirty", wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));
+      Wasm* wasm = (Wasm*)env;
+      Rect2i rect = Rect2i(args->data[0].of.i32, args->data[1].of.i32, args->data[2].of.i32, args->data[3].of.i32);
+      wasm->get_framebuffer()->mark_dirty(rect);
+      return wasi_result(results);
+    }
+
     wasm_func_t* wasi_callback(wasm_store_t* store, Wasm* wasm, callback_signature signature) {
       auto p_types = new std::vector<wasm_valtype_t*>;
       auto r_types = new std::vector<wasm_valtype_t*>;
@@ -213,6 +477,19 @@ namespace godot {
       { "wasi_snapshot_preview1.environ_get", { {WASM_I32, WASM_I32}, {WASM_I32}, wasi_environ_get } },
       { "wasi_snapshot_preview1.random_get", { {WASM_I32, WASM_I32}, {WASM_I32}, wasi_random_get } },
       { "wasi_snapshot_preview1.clock_time_get", { {WASM_I32, WASM_I64, WASM_I32}, {WASM_I32}, wasi_clock_time_get } },
+      { "wasi_snapshot_preview1.fd_prestat_get", { {WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_prestat_get } },
+      { "wasi_snapshot_preview1.fd_prestat_dir_name", { {WASM_I32, WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_prestat_dir_name } },
+      { "wasi_snapshot_preview1.fd_fdstat_get", { {WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_fdstat_get } },
+      { "wasi_snapshot_preview1.path_open", { {WASM_I32, WASM_I32, WASM_I32, WASM_I32, WASM_I32, WASM_I64, WASM_I64, WASM_I32, WASM_I32}, {WASM_I32}, wasi_path_open } },
+      { "wasi_snapshot_preview1.fd_read", { {WASM_I32, WASM_I32, WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_read } },
+      { "wasi_snapshot_preview1.fd_pread", { {WASM_I32, WASM_I32, WASM_I32, WASM_I64, WASM_I32}, {WASM_I32}, wasi_fd_pread } },
+      { "wasi_snapshot_preview1.fd_seek", { {WASM_I32, WASM_I64, WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_seek } },
+      { "wasi_snapshot_preview1.fd_close", { {WASM_I32}, {WASM_I32}, wasi_fd_close } },
+      { "wasi_snapshot_preview1.fd_filestat_get", { {WASM_I32, WASM_I32}, {WASM_I32}, wasi_fd_filestat_get } },
+      { "wasi_snapshot_preview1.fd_readdir", { {WASM_I32, WASM_I32, WASM_I32, WASM_I64, WASM_I32}, {WASM_I32}, wasi_fd_readdir } },
+
+      { "godot.framebuffer_register", { {WASM_I32, WASM_I32, WASM_I32}, {WASM_I32}, godot_framebuffer_register } },
+      { "godot.framebuffer_dirty", { {WASM_I32, WASM_I32, WASM_I32, WASM_I32}, {WASM_I32}, godot_framebuffer_dirty } },
 
       { "godot.node3D_set_transform", { {WASM_I64, WASM_I64}, {}, WasmShimNode3D::set_transform } },
       { "godot.node3D_get_transform", { {WASM_I64, WASM_I64}, {}, WasmShimNode3D::get_transform } },
@@ -276,6 +553,9 @@ namespace godot {
       { "godot.node3D_look_at_from_position", { {WASM_I64, WASM_I64, WASM_I64, WASM_I64, WASM_I64}, {}, WasmShimNode3D::look_at_from_position } },
       { "godot.node3D_to_local", { {WASM_I64, WASM_I64}, {}, WasmShimNode3D::to_local } },
       { "godot.node3D_to_global", { {WASM_I64, WASM_I64}, {}, WasmShimNode3D::to_global } },
+
+      { "godot.physics3D_intersect_rays", { {WASM_I64, WASM_I64, WASM_I64, WASM_I64}, {WASM_I32}, WasmShimPhysics3D::intersect_rays } },
+      { "godot.physics3D_cast_shapes", { {WASM_I64, WASM_I64, WASM_I64, WASM_I64}, {WASM_I32}, WasmShimPhysics3D::cast_shapes } },
     };
   }
 
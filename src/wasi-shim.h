@@ -5,6 +5,19 @@
 #include "wasm.h"
 #include "defs.h"
 
+// See https://github.com/WebAssembly/wasi-libc/blob/main/libc-bottom-half/headers/public/wasi/api.h
+#define __WASI_ERRNO_SUCCESS (UINT16_C(0)) // No error occurred
+#define __WASI_ERRNO_ACCES (UINT16_C(2)) // [sic] Permission denied
+#define __WASI_ERRNO_BADF (UINT16_C(8)) // Bad file descriptor
+#define __WASI_ERRNO_INVAL (UINT16_C(28)) // Invalid argument
+#define __WASI_ERRNO_IO (UINT16_C(29)) // I/O error
+#define __WASI_ERRNO_ISDIR (UINT16_C(31)) // Is a directory
+#define __WASI_ERRNO_NFILE (UINT16_C(41)) // Too many files open in system
+#define __WASI_ERRNO_NOENT (UINT16_C(44)) // No such file or directory
+#define __WASI_ERRNO_NOTDIR (UINT16_C(54)) // Not a directory or a symbolic link to a directory
+#define __WASI_ERRNO_ROFS (UINT16_C(69)) // Read-only file system
+#define __WASI_ERRNO_NOTCAPABLE (UINT16_C(76)) // Extension: Capabilities insufficient
+
 namespace godot {
   class Wasm; // Forward declare to avoid circular dependency
 
@@ -0,0 +1,149 @@
+#include <atomic>
+#include "wasm-engine-config.h"
+
+#ifdef WASMER
+  #include "wasmer.h"
+#elif defined(WASMTIME)
+  #include "wasmtime.h"
+#endif
+
+namespace godot {
+  namespace {
+    // Plain values as Godot types may not be constructed before the extension is initialized
+    #define SETTING_DEFAULT(id, name, type, hint, hint_string, value) value,
+    int64_t values[WasmEngineConfig::SETTING_COUNT] = { ENGINE_SETTINGS(SETTING_DEFAULT) };
+    std::atomic<bool> locked(false);
+
+    int16_t find_setting(const String &name) {
+      #define SETTING_FIND(id, name_, type, hint, hint_string, value) if (name == name_) return WasmEngineConfig::id;
+      ENGINE_SETTINGS(SETTING_FIND)
+      return -1;
+    }
+
+    Variant to_variant(int16_t setting) {
+      switch (setting) {
+        #define SETTING_VARIANT(id, name, type, hint, hint_string, value) case WasmEngineConfig::id: return Variant::type == Variant::BOOL ? Variant((bool)values[setting]) : Variant(values[setting]);
+        ENGINE_SETTINGS(SETTING_VARIANT)
+        default: return NULL_VARIANT;
+      }
+    }
+
+    Variant define_setting(const String &name, Variant::Type type, PropertyHint hint, const String &hint_string, const Variant &value) {
+      const String path = ENGINE_SETTINGS_PREFIX + name;
+      #ifdef GODOT_MODULE
+        return GLOBAL_DEF(PropertyInfo(type, path, hint, hint_string), value);
+      #else
+        ProjectSettings* settings = ProjectSettings::get_singleton();
+        if (!settings->has_setting(path)) settings->set_setting(path, value);
+        settings->set_initial_value(path, value);
+        Dictionary info;
+        info["name"] = path;
+        info["type"] = type;
+        info["hint"] = hint;
+        info["hint_string"] = hint_string;
+        settings->add_property_info(info);
+        return settings->get_setting(path);
+      #endif
+    }
+  }
+
+  void WasmEngineConfig::REGISTRATION_METHOD() {
+    ClassDB::bind_static_method("WasmEngineConfig", D_METHOD("set_setting", "name", "value"), &WasmEngineConfig::set_setting);
+    ClassDB::bind_static_method("WasmEngineConfig", D_METHOD("get_setting", "name"), &WasmEngineConfig::get_setting);
+    ClassDB::bind_static_method("WasmEngineConfig", D_METHOD("get_settings"), &WasmEngineConfig::get_settings);
+    ClassDB::bind_static_method("WasmEngineConfig", D_METHOD("is_locked"), &WasmEngineConfig::is_locked);
+    ClassDB::bind_static_method("WasmEngineConfig", D_METHOD("is_supported", "name"), &WasmEngineConfig::is_supported);
+  }
+
+  void WasmEngineConfig::load_project_settings() {
+    // Called at initialization before any engine is created
+    #define SETTING_LOAD(id, name, type, hint, hint_string, value) \
+      set_setting(name, define_setting(name, Variant::type, hint, hint_string, Variant::type == Variant::BOOL ? Variant((bool)value) : Variant((int64_t)value)));
+    ENGINE_SETTINGS(SETTING_LOAD)
+  }
+
+  godot_error WasmEngineConfig::set_setting(const String &name, const Variant &value) {
+    const int16_t setting = find_setting(name);
+    FAIL_IF(setting < 0, "Unknown engine setting " + name, ERR_INVALID_PARAMETER);
+    FAIL_IF(locked, "Engine configuration locked once engine is created", ERR_LOCKED);
+    FAIL_IF(value.get_type() != Variant::INT && value.get_type() != Variant::BOOL, "Invalid engine setting value", ERR_INVALID_PARAMETER);
+    const bool enumerated = setting == COMPILER || setting == OPTIMIZATION_LEVEL;
+    FAIL_IF(enumerated && ((int64_t)value < 0 || (int64_t)value > 3), "Invalid engine setting value", ERR_INVALID_PARAMETER);
+    values[setting] = value;
+    return OK;
+  }
+
+  Variant WasmEngineConfig::get_setting(const String &name) {
+    const int16_t setting = find_setting(name);
+    FAIL_IF(setting < 0, "Unknown engine setting " + name, NULL_VARIANT);
+    return to_variant(setting);
+  }
+
+  Dictionary WasmEngineConfig::get_settings() {
+    Dictionary settings;
+    #define SETTING_DICT(id, name, type, hint, hint_string, value) settings[name] = to_variant(id);
+    ENGINE_SETTINGS(SETTING_DICT)
+    return settings;
+  }
+
+  bool WasmEngineConfig::is_locked() {
+    return locked;
+  }
+
+  bool WasmEngineConfig::is_supported(const String &name) {
+    // Whether the runtime honours the setting; see create_config
+    const int16_t setting = find_setting(name);
+    FAIL_IF(setting < 0, "Unknown engine setting " + name, false);
+    switch (setting) {
+      #ifdef WASMER
+        case OPTIMIZATION_LEVEL: case NAN_CANONICALIZATION: case MEMORY_RESERVATION: case MEMORY_GUARD_SIZE: return false;
+      #elif defined(WASMTIME)
+        case TAIL_CALL: return false;
+      #endif
+      default: return true;
+    }
+  }
+
+  wasm_config_t* WasmEngineConfig::create_config() {
+    // Settings unsupported by the runtime are reported and otherwise ignored
+    locked = true;
+    wasm_config_t* config = wasm_config_new();
+    #ifdef WASMER
+      const wasmer_compiler_t compilers[] = { CRANELIFT, CRANELIFT, LLVM, SINGLEPASS };
+      const wasmer_compiler_t compiler = compilers[values[COMPILER]];
+      if (values[COMPILER] != COMPILER_DEFAULT) {
+        if (wasmer_is_compiler_available(compiler)) wasm_config_set_compiler(config, compiler);
+        else PRINT_ERROR("Configured compiler unavailable");
+      }
+      if (values[OPTIMIZATION_LEVEL] != OPTIMIZATION_DEFAULT) PRINT_ERROR("Optimization level unsupported by Wasmer");
+      wasmer_features_t* features = wasmer_features_new();
+      wasmer_features_simd(features, values[SIMD]);
+      wasmer_features_threads(features, values[THREADS]);
+      wasmer_features_bulk_memory(features, values[BULK_MEMORY]);
+      wasmer_features_reference_types(features, values[REFERENCE_TYPES]);
+      wasmer_features_multi_value(features, values[MULTI_VALUE]);
+      wasmer_features_tail_call(features, values[TAIL_CALL]);
+      wasm_config_set_features(config, features);
+      if (values[NAN_CANONICALIZATION]) PRINT_ERROR("NaN canonicalization unsupported by Wasmer C API");
+      if (values[MEMORY_RESERVATION] || values[MEMORY_GUARD_SIZE]) PRINT_ERROR("Memory tuning unsupported by Wasmer");
+    #elif defined(WASMTIME)
+      if (values[COMPILER] == COMPILER_CRANELIFT) wasmtime_config_strategy_set(config, WASMTIME_STRATEGY_CRANELIFT);
+      else if (values[COMPILER] != COMPILER_DEFAULT) PRINT_ERROR("Configured compiler unavailable");
+      const wasmtime_opt_level_t levels[] = { WASMTIME_OPT_LEVEL_SPEED, WASMTIME_OPT_LEVEL_NONE, WASMTIME_OPT_LEVEL_SPEED, WASMTIME_OPT_LEVEL_SPEED_AND_SIZE };
+      if (values[OPTIMIZATION_LEVEL] != OPTIMIZATION_DEFAULT) wasmtime_config_cranelift_opt_level_set(config, levels[values[OPTIMIZATION_LEVEL]]);
+      wasmtime_config_wasm_simd_set(config, values[SIMD]);
+      wasmtime_config_wasm_threads_set(config, values[THREADS]);
+      wasmtime_config_wasm_bulk_memory_set(config, values[BULK_MEMORY]);
+      wasmtime_config_wasm_reference_types_set(config, values[REFERENCE_TYPES]);
+      wasmtime_config_wasm_multi_value_set(config, values[MULTI_VALUE]);
+      if (values[TAIL_CALL]) PRINT_ERROR("Tail calls unsupported by Wasmtime C API");
+      wasmtime_config_cranelift_nan_canonicalization_set(config, values[NAN_CANONICALIZATION]);
+      if (values[MEMORY_RESERVATION]) wasmtime_config_static_memory_maximum_size_set(config, values[MEMORY_RESERVATION]);
+      if (values[MEMORY_GUARD_SIZE]) {
+        wasmtime_config_static_memory_guard_size_set(config, values[MEMORY_GUARD_SIZE]);
+        wasmtime_config_dynamic_memory_guard_size_set(config, values[MEMORY_GUARD_SIZE]);
+      }
+    #endif
+    return config;
+  }
+}
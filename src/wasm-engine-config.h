@@ -0,0 +1,53 @@
+#ifndef WASM_ENGINE_CONFIG_H
+#define WASM_ENGINE_CONFIG_H
+
+#include "wasm.h"
+#include "defs.h"
+
+#define ENGINE_SETTINGS_PREFIX "wasm/engine/"
+
+// Engine settings: (identifier, name, Variant type, property hint, hint string, default)
+#ifdef WASMER
+  #define THREADS_DEFAULT 1 // Matches runtime default features
+#else
+  #define THREADS_DEFAULT 0
+#endif
+#define ENGINE_SETTINGS(X) \
+  X(COMPILER, "compiler", INT, PROPERTY_HINT_ENUM, "Default,Cranelift,LLVM,Singlepass", 0) \
+  X(OPTIMIZATION_LEVEL, "optimization_level", INT, PROPERTY_HINT_ENUM, "Default,None,Speed,Speed and Size", 0) \
+  X(SIMD, "features/simd", BOOL, PROPERTY_HINT_NONE, "", 1) \
+  X(THREADS, "features/threads", BOOL, PROPERTY_HINT_NONE, "", THREADS_DEFAULT) \
+  X(BULK_MEMORY, "features/bulk_memory", BOOL, PROPERTY_HINT_NONE, "", 1) \
+  X(REFERENCE_TYPES, "features/reference_types", BOOL, PROPERTY_HINT_NONE, "", 1) \
+  X(MULTI_VALUE, "features/multi_value", BOOL, PROPERTY_HINT_NONE, "", 1) \
+  X(TAIL_CALL, "features/tail_call", BOOL, PROPERTY_HINT_NONE, "", 0) \
+  X(NAN_CANONICALIZATION, "determinism/nan_canonicalization", BOOL, PROPERTY_HINT_NONE, "", 0) \
+  X(MEMORY_RESERVATION, "memory/reservation", INT, PROPERTY_HINT_RANGE, "0,17179869184,65536,or_greater,suffix:B", 0) \
+  X(MEMORY_GUARD_SIZE, "memory/guard_size", INT, PROPERTY_HINT_RANGE, "0,4294967296,65536,or_greater,suffix:B", 0)
+
+namespace godot {
+  // Configuration of the engine shared by all Wasm instances; fixed once the engine is created
+  class WasmEngineConfig : public Object {
+    GDCLASS(WasmEngineConfig, Object);
+
+    public:
+      enum Setting {
+        #define SETTING_ENUM(id, name, type, hint, hint_string, value) id,
+        ENGINE_SETTINGS(SETTING_ENUM)
+        SETTING_COUNT,
+      };
+      enum Compiler { COMPILER_DEFAULT, COMPILER_CRANELIFT, COMPILER_LLVM, COMPILER_SINGLEPASS };
+      enum OptimizationLevel { OPTIMIZATION_DEFAULT, OPTIMIZATION_NONE, OPTIMIZATION_SPEED, OPTIMIZATION_SPEED_AND_SIZE };
+
+      static void REGISTRATION_METHOD();
+      static void load_project_settings();
+      static godot_error set_setting(const String &name, const Variant &value);
+      static Variant get_setting(const String &name);
+      static Dictionary get_settings();
+      static bool is_locked();
+      static bool is_supported(const String &name);
+      static wasm_config_t* create_config(); // Locks configuration
+  };
+}
+
+#endif
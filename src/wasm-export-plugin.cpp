@@ -0,0 +1,56 @@
+#include "wasm-export-plugin.h"
+
+#ifdef WASM_EDITOR_ENABLED
+
+#include "wasm-module.h"
+
+namespace godot {
+  namespace {
+    const char* ARCHITECTURES[] = { "x86_64", "x86_32", "arm64", "arm32", "rv64", "ppc64", "ppc32" };
+
+    template <typename T> bool is_host_target(const T &features) {
+      // Runtimes only compile for the host so artifacts are limited to exports matching the editor platform
+      OS* os = OS::get_singleton();
+      if (!features.has(os->get_name().to_lower())) return false;
+      // Universal binaries list several architectures; a single artifact cannot serve all of them
+      uint8_t count = 0;
+      bool host = false;
+      for (const char* arch: ARCHITECTURES) {
+        if (!features.has(arch)) continue;
+        count++;
+        host = os->has_feature(arch);
+      }
+      return count == 1 && host;
+    }
+  }
+
+  void WasmExportPlugin::REGISTRATION_METHOD() { }
+
+  String WasmExportPlugin::INTERFACE_GET_NAME {
+    return "Godot Wasm";
+  }
+
+  void WasmExportPlugin::INTERFACE_EXPORT_FILE {
+    if (path.get_extension().to_lower() != "wasm" || !is_host_target(features)) return;
+    const PackedByteArray native = WasmModule::precompile(FileAccess::get_file_as_bytes(path));
+    FAIL_IF(native.is_empty(), "Failed to precompile " + path, );
+    add_file(path + WASM_NATIVE_EXTENSION, native, false);
+  }
+
+  void WasmEditorPlugin::REGISTRATION_METHOD() { }
+
+  void WasmEditorPlugin::_notification(int what) {
+    switch (what) {
+      case NOTIFICATION_ENTER_TREE:
+        INSTANTIATE_REF(export_plugin);
+        add_export_plugin(export_plugin);
+        break;
+      case NOTIFICATION_EXIT_TREE:
+        remove_export_plugin(export_plugin);
+        export_plugin.unref();
+        break;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef WASM_EXPORT_PLUGIN_H
+#define WASM_EXPORT_PLUGIN_H
+
+#include "defs.h"
+
+// Editor classes are only compiled into editor builds of the module; the extension library is shared by editor and templates
+#if defined(TOOLS_ENABLED) || !defined(GODOT_MODULE)
+  #define WASM_EDITOR_ENABLED
+#endif
+
+#ifdef WASM_EDITOR_ENABLED
+
+#ifdef GODOT_MODULE
+  #include "editor/export/editor_export_plugin.h"
+  #include "editor/editor_plugin.h"
+  #define INTERFACE_GET_NAME _get_name() const
+  #define INTERFACE_EXPORT_FILE _export_file(const String &path, const String &type, const HashSet<String> &features)
+#else
+  #include "godot_cpp/classes/editor_export_plugin.hpp"
+  #include "godot_cpp/classes/editor_plugin.hpp"
+  #include "godot_cpp/classes/editor_plugin_registration.hpp"
+  #define INTERFACE_GET_NAME _get_name() const
+  #define INTERFACE_EXPORT_FILE _export_file(const String &path, const String &type, const PackedStringArray &features)
+#endif
+
+namespace godot {
+  // Packs a precompiled native artifact alongside each exported .wasm file
+  class WasmExportPlugin : public EditorExportPlugin {
+    GDCLASS(WasmExportPlugin, EditorExportPlugin);
+
+    public:
+      static void REGISTRATION_METHOD();
+      String INTERFACE_GET_NAME override;
+      void INTERFACE_EXPORT_FILE override;
+  };
+
+  class WasmEditorPlugin : public EditorPlugin {
+    GDCLASS(WasmEditorPlugin, EditorPlugin);
+
+    private:
+      Ref<WasmExportPlugin> export_plugin;
+
+    public:
+      static void REGISTRATION_METHOD();
+      void _notification(int what);
+  };
+}
+
+#endif
+
+#endif
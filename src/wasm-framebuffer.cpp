@@ -0,0 +1,114 @@
+#include "wasm.h"
+#include "wasm-framebuffer.h"
+
+#define PIXEL_SIZE 4 // RGBA8
+#define DIRTY_RECTS_MAX 16 // Merge into a single bounding rect beyond this
+
+namespace godot {
+  namespace {
+    Rect2i bounding_rect(const std::vector<Rect2i>& rects) {
+      Rect2i merged = rects.front();
+      for (const auto &rect: rects) merged = merged.merge(rect);
+      return merged;
+    }
+  }
+
+  void WasmFramebuffer::REGISTRATION_METHOD() {
+    ClassDB::bind_method(D_METHOD("bind", "memory", "offset", "width", "height"), &WasmFramebuffer::bind);
+    ClassDB::bind_method(D_METHOD("mark_dirty", "rect"), &WasmFramebuffer::mark_dirty);
+    ClassDB::bind_method(D_METHOD("flush"), &WasmFramebuffer::flush);
+    ClassDB::bind_method(D_METHOD("get_texture"), &WasmFramebuffer::get_texture);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "texture"), "", "get_texture");
+  }
+
+  WasmFramebuffer::WasmFramebuffer() {
+    offset = 0;
+    width = 0;
+    height = 0;
+    back = 0;
+    flush_queued = false;
+  }
+
+  WasmFramebuffer::~WasmFramebuffer() { }
+
+  void WasmFramebuffer::_init() { }
+
+  void WasmFramebuffer::copy_rect(uint8_t* buffer, const byte_t* data, const Rect2i& rect) const {
+    // Rows of a rect are contiguous in both linear memory and image data
+    for (int32_t y = rect.position.y; y < rect.position.y + rect.size.y; y++) {
+      size_t row = ((size_t)y * width + rect.position.x) * PIXEL_SIZE;
+      memcpy(buffer + row, data + row, (size_t)rect.size.x * PIXEL_SIZE);
+    }
+  }
+
+  godot_error WasmFramebuffer::bind(const Ref<WasmMemory> memory, uint32_t offset, int32_t width, int32_t height) {
+    FAIL_IF(memory.is_null() || memory->get_memory() == NULL, "Invalid memory", ERR_INVALID_PARAMETER);
+    FAIL_IF(width <= 0 || height <= 0, "Invalid framebuffer size", ERR_INVALID_PARAMETER);
+    size_t length = (size_t)width * height * PIXEL_SIZE;
+    FAIL_IF(offset + length > wasm_memory_data_size(memory->get_memory()), "Framebuffer out of bounds", ERR_PARAMETER_RANGE_ERROR);
+    if (this->memory == memory && this->offset == offset && this->width == width && this->height == height) return OK;
+
+    this->memory = memory;
+    this->offset = offset;
+    this->width = width;
+    this->height = height;
+    {
+      std::lock_guard<std::mutex> guard(dirty_lock);
+      dirty.clear();
+    }
+    stale.clear();
+    back = 0;
+
+    // Seed both buffers with the full region
+    const byte_t* data = wasm_memory_data(memory->get_memory()) + offset;
+    for (auto i = 0; i < 2; i++) {
+      buffers[i].resize(length);
+      memcpy(buffers[i].ptrw(), data, length);
+      images[i] = Ref<Image>();
+    }
+    Ref<Image> image = Image::create_from_data(width, height, false, Image::FORMAT_RGBA8, buffers[back]);
+    texture = ImageTexture::create_from_image(image);
+    return OK;
+  }
+
+  void WasmFramebuffer::mark_dirty(const Rect2i rect) {
+    Rect2i clipped = rect.intersection(Rect2i(0, 0, width, height));
+    if (clipped.size.x <= 0 || clipped.size.y <= 0) return;
+    std::lock_guard<std::mutex> guard(dirty_lock);
+    dirty.push_back(clipped);
+    if (dirty.size() > DIRTY_RECTS_MAX) dirty = { bounding_rect(dirty) };
+    if (flush_queued) return;
+    flush_queued = true;
+    call_deferred("flush"); // Upload once per frame regardless of dirty rect count
+  }
+
+  bool WasmFramebuffer::flush() {
+    // Take dirty regions such that the module may keep reporting while copying
+    std::vector<Rect2i> pending;
+    {
+      std::lock_guard<std::mutex> guard(dirty_lock);
+      flush_queued = false;
+      pending.swap(dirty);
+    }
+    if (pending.empty() || texture.is_null()) return false;
+    FAIL_IF(memory.is_null() || memory->get_memory() == NULL, "Invalid memory", false);
+    const byte_t* data = wasm_memory_data(memory->get_memory()) + offset;
+
+    // Release our reference to the back image so the buffer is not copied on write unless the renderer still holds it
+    images[back] = Ref<Image>();
+    uint8_t* buffer = buffers[back].ptrw();
+    for (const auto &rect: stale) copy_rect(buffer, data, rect);
+    for (const auto &rect: pending) copy_rect(buffer, data, rect);
+
+    // Upload and swap
+    images[back] = Image::create_from_data(width, height, false, Image::FORMAT_RGBA8, buffers[back]);
+    texture->update(images[back]);
+    stale.swap(pending);
+    back ^= 1;
+    return true;
+  }
+
+  Ref<Texture2D> WasmFramebuffer::get_texture() const {
+    return texture;
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef WASM_FRAMEBUFFER_H
+#define WASM_FRAMEBUFFER_H
+
+#include <vector>
+#include <mutex>
+#include "defs.h"
+#include "wasm-memory.h"
+
+namespace godot {
+  class WasmFramebuffer : public RefCounted {
+    GDCLASS(WasmFramebuffer, RefCounted);
+
+    private:
+      Ref<WasmMemory> memory;
+      uint32_t offset; // RGBA8 pixel region offset within linear memory
+      int32_t width;
+      int32_t height;
+      PackedByteArray buffers[2]; // Double buffered pixel data
+      Ref<Image> images[2]; // Images sharing buffer data; may still be referenced by the renderer
+      uint8_t back; // Index of buffer written by next flush
+      std::vector<Rect2i> dirty; // Regions changed since last flush; reported by module possibly off main thread
+      std::vector<Rect2i> stale; // Regions changed by last flush and missing from back buffer
+      bool flush_queued;
+      std::mutex dirty_lock; // Guards dirty and flush_queued
+      Ref<ImageTexture> texture;
+      void copy_rect(uint8_t* buffer, const byte_t* data, const Rect2i& rect) const;
+
+    public:
+      static void REGISTRATION_METHOD();
+      WasmFramebuffer();
+      ~WasmFramebuffer();
+      void _init();
+      godot_error bind(const Ref<WasmMemory> memory, uint32_t offset, int32_t width, int32_t height);
+      void mark_dirty(const Rect2i rect);
+      bool flush();
+      Ref<Texture2D> get_texture() const;
+  };
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "wasm.h"
 #include "wasm-memory.h"
 #include "store.h"
+#include "memory-backing.h"
+#include "defer.h"
 
 #ifdef GDNATIVE
   #define INTERFACE_DEFINE interface = { { 3, 1 }, this, &_get_data, &_get_partial_data, &_put_data, &_put_partial_data, &_get_available_bytes, NULL }
@@ -27,6 +29,22 @@ namespace godot {
     #else
       ClassDB::bind_method(D_METHOD("inspect"), &WasmMemory::inspect);
       ClassDB::bind_method(D_METHOD("grow", "pages"), &WasmMemory::grow);
+      ClassDB::bind_method(D_METHOD("check_growth"), &WasmMemory::check_growth);
+      ClassDB::bind_method(D_METHOD("set_max_pages", "pages"), &WasmMemory::set_max_pages);
+      ClassDB::bind_method(D_METHOD("get_max_pages"), &WasmMemory::get_max_pages);
+      ClassDB::bind_method(D_METHOD("set_growth_factor", "factor"), &WasmMemory::set_growth_factor);
+      ClassDB::bind_method(D_METHOD("get_growth_factor"), &WasmMemory::get_growth_factor);
+      ClassDB::bind_method(D_METHOD("advise_hugepages", "enabled"), &WasmMemory::advise_hugepages, DEFVAL(true));
+      ClassDB::bind_method(D_METHOD("prefault", "bytes"), &WasmMemory::prefault, DEFVAL(-1));
+      ClassDB::bind_method(D_METHOD("map_file", "path", "offset", "file_offset", "length"), &WasmMemory::map_file, DEFVAL(0), DEFVAL(-1));
+      ClassDB::bind_method(D_METHOD("get_resident_size"), &WasmMemory::get_resident_size);
+      ClassDB::bind_method(D_METHOD("view", "offset", "length"), &WasmMemory::view, DEFVAL(-1));
+      ClassDB::bind_method(D_METHOD("is_view"), &WasmMemory::is_view);
+      ClassDB::bind_method(D_METHOD("copy_from", "other", "src_offset", "dst_offset", "length"), &WasmMemory::copy_from);
+      ClassDB::bind_method(D_METHOD("fill", "value", "offset", "length"), &WasmMemory::fill);
+      ADD_PROPERTY(PropertyInfo(Variant::INT, "max_pages"), "set_max_pages", "get_max_pages");
+      ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "growth_factor", PROPERTY_HINT_RANGE, "1,4,0.1,or_greater"), "set_growth_factor", "get_growth_factor");
+      ADD_SIGNAL(MethodInfo("memory_grown", PropertyInfo(Variant::INT, "old_pages"), PropertyInfo(Variant::INT, "new_pages")));
       ClassDB::bind_method(D_METHOD("seek", "p_pos"), &WasmMemory::seek);
       ClassDB::bind_method(D_METHOD("get_position"), &WasmMemory::get_position);
     #endif
@@ -36,6 +54,11 @@ namespace godot {
     INTERFACE_DEFINE;
     memory = NULL;
     pointer = 0;
+    pages = 0;
+    max_pages = -1;
+    growth_factor = 1.0;
+    view_offset = 0;
+    view_length = -1;
   }
 
   WasmMemory::~WasmMemory() {
@@ -49,6 +72,7 @@ namespace godot {
   void WasmMemory::set_memory(const wasm_memory_t* memory) {
     if (this->memory != NULL) wasm_memory_delete(this->memory);
     this->memory = (wasm_memory_t*)memory;
+    pages = memory == NULL ? 0 : wasm_memory_size(memory);
   }
 
   wasm_memory_t* WasmMemory::get_memory() const {
@@ -66,13 +90,127 @@ namespace godot {
   }
 
   godot_error WasmMemory::grow(uint32_t pages) {
+    FAIL_IF(is_view(), "Memory view can not be grown", ERR_UNAVAILABLE);
     if (!memory) { // Create new memory
-      const wasm_limits_t limits = { pages, wasm_limits_max_default };
-      memory = wasm_memory_new(STORE, wasm_memorytype_new(&limits));
+      FAIL_IF(max_pages >= 0 && pages > max_pages, "Memory exceeds maximum pages", ERR_PARAMETER_RANGE_ERROR);
+      const wasm_limits_t limits = { pages, max_pages < 0 ? wasm_limits_max_default : (uint32_t)max_pages };
+      wasm_memorytype_t* type = wasm_memorytype_new(&limits);
+      DEFER(wasm_memorytype_delete(type));
+      set_memory(wasm_memory_new(STORE, type));
       return memory ? OK : FAILED;
     }
+
+    // Grow by at least the growth factor to avoid repeated small grows, within the maximum
+    if (pages == 0) return OK; // Growth factor only applies to actual growth
+    const uint64_t current = wasm_memory_size(memory);
+    wasm_memorytype_t* type = wasm_memory_type(memory);
+    const uint64_t maximum = wasm_memorytype_limits(type)->max;
+    wasm_memorytype_delete(type);
+    uint64_t delta = MAX((uint64_t)pages, (uint64_t)(current * (growth_factor - 1.0)));
+    if (current + delta > maximum) delta = pages;
+    if (!wasm_memory_grow(memory, delta)) return FAILED;
+    check_growth();
+    return OK;
+  }
+
+  bool WasmMemory::check_growth() {
+    // Called after module execution and host growth; memory data may have moved
+    if (memory == NULL) return false;
+    const uint32_t current = wasm_memory_size(memory);
+    if (current == pages) return false;
+    const uint32_t previous = pages;
+    pages = current;
+    emit_signal("memory_grown", previous, current);
+    return true;
+  }
+
+  void WasmMemory::set_max_pages(int64_t pages) {
+    max_pages = pages; // Applies to memory created by next grow
+  }
+
+  int64_t WasmMemory::get_max_pages() const {
+    return max_pages;
+  }
+
+  void WasmMemory::set_growth_factor(double factor) {
+    FAIL_IF(factor < 1.0, "Invalid growth factor", );
+    growth_factor = factor;
+  }
+
+  double WasmMemory::get_growth_factor() const {
+    return growth_factor;
+  }
+
+  godot_error WasmMemory::advise_hugepages(bool enabled) {
+    // Applies to pages of the current size; repeat once memory has grown
+    FAIL_IF(memory == NULL, "Invalid memory", ERR_INVALID_DATA);
+    return godot_wasm::advise_hugepages((uint8_t*)wasm_memory_data(memory), wasm_memory_data_size(memory), enabled);
+  }
+
+  godot_error WasmMemory::prefault(int64_t bytes) {
+    FAIL_IF(memory == NULL, "Invalid memory", ERR_INVALID_DATA);
+    const size_t size = wasm_memory_data_size(memory);
+    return godot_wasm::prefault((uint8_t*)wasm_memory_data(memory), bytes < 0 ? size : MIN((size_t)bytes, size));
+  }
+
+  godot_error WasmMemory::map_file(const String &path, uint32_t offset, uint64_t file_offset, int64_t length) {
     FAIL_IF(memory == NULL, "Invalid memory", ERR_INVALID_DATA);
-    return wasm_memory_grow(memory, pages) ? OK : FAILED;
+    if (length < 0) {
+      Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+      FAIL_IF(file.is_null(), "Failed to open file " + path, ERR_FILE_CANT_OPEN);
+      FAIL_IF(file->get_length() < file_offset, "File region out of bounds", ERR_PARAMETER_RANGE_ERROR);
+      length = file->get_length() - file_offset;
+    }
+    byte_t* data = region(offset, length);
+    FAIL_IF(data == NULL, "Memory region out of bounds", ERR_PARAMETER_RANGE_ERROR);
+    return godot_wasm::map_file_region((uint8_t*)data, length, path, file_offset);
+  }
+
+  int64_t WasmMemory::get_resident_size() const {
+    if (memory == NULL) return 0;
+    return godot_wasm::resident_size((const uint8_t*)wasm_memory_data(memory), wasm_memory_data_size(memory));
+  }
+
+  byte_t* WasmMemory::region(uint64_t offset, uint64_t length) const {
+    // Bytes at offset within view, or NULL if out of bounds; memory data may move on growth
+    if (memory == NULL) return NULL;
+    const uint64_t size = view_length < 0 ? wasm_memory_data_size(memory) - view_offset : view_length;
+    if (offset + length > size) return NULL;
+    return wasm_memory_data(memory) + view_offset + offset;
+  }
+
+  bool WasmMemory::is_view() const {
+    return view_offset != 0 || view_length >= 0;
+  }
+
+  Ref<WasmMemory> WasmMemory::view(uint32_t offset, int64_t length) {
+    // View shares memory such that writes are visible to all instances and other views
+    FAIL_IF(memory == NULL, "Invalid memory", Ref<WasmMemory>());
+    FAIL_IF(region(offset, length < 0 ? 0 : length) == NULL, "Memory region out of bounds", Ref<WasmMemory>());
+    Ref<WasmMemory> ref;
+    INSTANTIATE_REF(ref);
+    ref->set_memory(wasm_memory_copy(memory));
+    ref->view_offset = view_offset + offset;
+    ref->view_length = length;
+    if (length < 0 && view_length >= 0) ref->view_length = view_length - offset; // Bounded by this view
+    return ref;
+  }
+
+  godot_error WasmMemory::copy_from(Ref<WasmMemory> other, uint32_t src_offset, uint32_t dst_offset, uint32_t length) {
+    // Single move between memories, which may be the same or overlapping views
+    FAIL_IF(other.is_null(), "Invalid source memory", ERR_INVALID_PARAMETER);
+    const byte_t* src = other->region(src_offset, length);
+    byte_t* dst = region(dst_offset, length);
+    FAIL_IF(src == NULL || dst == NULL, "Memory region out of bounds", ERR_PARAMETER_RANGE_ERROR);
+    memmove(dst, src, length);
+    return OK;
+  }
+
+  godot_error WasmMemory::fill(uint8_t value, uint32_t offset, uint32_t length) {
+    byte_t* data = region(offset, length);
+    FAIL_IF(data == NULL, "Memory region out of bounds", ERR_PARAMETER_RANGE_ERROR);
+    memset(data, value, length);
+    return OK;
   }
 
   Ref<WasmMemory> WasmMemory::seek(int p_pos) {
@@ -88,7 +226,8 @@ namespace godot {
 
   godot_error WasmMemory::INTERFACE_GET_DATA {
     FAIL_IF(memory == NULL, "Invalid memory", ERR_INVALID_DATA);
-    byte_t* data = wasm_memory_data(memory) + pointer;
+    const byte_t* data = region(pointer, MAX(bytes, 0));
+    FAIL_IF(data == NULL, "Memory region out of bounds", ERR_PARAMETER_RANGE_ERROR);
     memcpy(buffer, data, bytes);
     pointer += bytes;
     #ifndef GODOT_MODULE
@@ -109,7 +248,8 @@ namespace godot {
   godot_error WasmMemory::INTERFACE_PUT_DATA {
     FAIL_IF(memory == NULL, "Invalid memory", ERR_INVALID_DATA);
     if (bytes <= 0) return OK;
-    byte_t* data = wasm_memory_data(memory) + pointer;
+    byte_t* data = region(pointer, bytes);
+    FAIL_IF(data == NULL, "Memory region out of bounds", ERR_PARAMETER_RANGE_ERROR);
     memcpy(data, buffer, bytes);
     pointer += bytes;
     #ifndef GODOT_MODULE
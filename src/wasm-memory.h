@@ -29,6 +29,12 @@ namespace godot {
       INTERFACE_DECLARE;
       wasm_memory_t* memory;
       uint32_t pointer;
+      uint32_t pages; // Size last observed; compared to detect growth by the module
+      int64_t max_pages; // Maximum of memory created via grow; negative for runtime default
+      double growth_factor; // Minimum growth relative to current size
+      uint32_t view_offset; // Start of view within memory
+      int64_t view_length; // Length of view; negative if extending to end of memory
+      byte_t* region(uint64_t offset, uint64_t length) const;
 
     public:
       static void REGISTRATION_METHOD();
@@ -39,6 +45,19 @@ namespace godot {
       wasm_memory_t* get_memory() const;
       Dictionary inspect() const;
       godot_error grow(uint32_t pages);
+      bool check_growth();
+      void set_max_pages(int64_t pages);
+      int64_t get_max_pages() const;
+      void set_growth_factor(double factor);
+      double get_growth_factor() const;
+      godot_error advise_hugepages(bool enabled);
+      godot_error prefault(int64_t bytes);
+      godot_error map_file(const String &path, uint32_t offset, uint64_t file_offset, int64_t length);
+      int64_t get_resident_size() const;
+      bool is_view() const;
+      Ref<WasmMemory> view(uint32_t offset, int64_t length);
+      godot_error copy_from(Ref<WasmMemory> other, uint32_t src_offset, uint32_t dst_offset, uint32_t length);
+      godot_error fill(uint8_t value, uint32_t offset, uint32_t length);
       Ref<WasmMemory> seek(int p_pos);
       uint32_t get_position() const;
       godot_error INTERFACE_GET_DATA override;
@@ -0,0 +1,135 @@
+#include "wasm-module.h"
+#include "defer.h"
+#include "store.h"
+#include "decompress.h"
+
+namespace godot {
+  void WasmModule::REGISTRATION_METHOD() {
+    ClassDB::bind_method(D_METHOD("compile", "bytecode", "native"), &WasmModule::compile, DEFVAL(PackedByteArray()));
+    ClassDB::bind_method(D_METHOD("get_bytecode"), &WasmModule::get_bytecode);
+    ClassDB::bind_method(D_METHOD("is_precompiled"), &WasmModule::is_precompiled);
+    ClassDB::bind_static_method("WasmModule", D_METHOD("precompile", "bytecode"), &WasmModule::precompile);
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "bytecode", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "", "get_bytecode");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "precompiled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "", "is_precompiled");
+  }
+
+  WasmModule::WasmModule() {
+    module = NULL;
+    precompiled = false;
+  }
+
+  WasmModule::~WasmModule() {
+    if (module != NULL) wasm_module_delete(module);
+  }
+
+  void WasmModule::_init() { }
+
+  godot_error WasmModule::compile(const PackedByteArray &bytecode, const PackedByteArray &native) {
+    // Decompress gzip or zstd compressed bytecode
+    if (godot_wasm::is_compressed(BYTE_ARRAY_POINTER(bytecode), bytecode.size())) {
+      PackedByteArray decompressed;
+      godot_error err = godot_wasm::decompress(BYTE_ARRAY_POINTER(bytecode), bytecode.size(), decompressed);
+      FAIL_IF(err != OK, "Failed to decompress module", err);
+      return compile(decompressed, native);
+    }
+
+    if (module != NULL) wasm_module_delete(module);
+    module = NULL;
+    precompiled = false;
+    this->bytecode = bytecode;
+
+    // Temporary store as resources may be loaded from any thread; modules outlive their store
+    wasm_store_t* store = wasm_store_new(::godot_wasm::Store::instance().engine);
+    DEFER(wasm_store_delete(store));
+
+    // Deserialize precompiled artifact; the runtime rejects artifacts built by a different engine or target
+    if (native.size()) {
+      const wasm_byte_vec_t bytes = { (size_t)native.size(), (wasm_byte_t*)BYTE_ARRAY_POINTER(native) };
+      module = wasm_module_deserialize(store, &bytes);
+      precompiled = module != NULL;
+      if (precompiled) return OK;
+    }
+
+    // Fall back to compiling bytecode
+    const wasm_byte_vec_t bytes = { (size_t)bytecode.size(), (wasm_byte_t*)BYTE_ARRAY_POINTER(bytecode) };
+    FAIL_IF(!wasm_module_validate(store, &bytes), "Invalid binary", ERR_INVALID_DATA);
+    module = wasm_module_new(store, &bytes);
+    FAIL_IF(module == NULL, "Compilation failed", ERR_COMPILATION_FAILED);
+    return OK;
+  }
+
+  const wasm_module_t* WasmModule::get_module() const {
+    return module;
+  }
+
+  PackedByteArray WasmModule::get_bytecode() const {
+    return bytecode;
+  }
+
+  bool WasmModule::is_precompiled() const {
+    return precompiled;
+  }
+
+  PackedByteArray WasmModule::precompile(const PackedByteArray &bytecode) {
+    // Native artifact for the host engine and target
+    Ref<WasmModule> resource;
+    INSTANTIATE_REF(resource);
+    FAIL_IF(resource->compile(bytecode, PackedByteArray()) != OK, "Failed to precompile module", PackedByteArray());
+    wasm_byte_vec_t native;
+    wasm_module_serialize(resource->module, &native);
+    DEFER(wasm_byte_vec_delete(&native));
+    FAIL_IF(native.size == 0, "Failed to serialize module", PackedByteArray());
+    PackedByteArray result;
+    result.resize(native.size);
+    memcpy(result.ptrw(), native.data, native.size);
+    return result;
+  }
+
+  void ResourceFormatLoaderWasm::REGISTRATION_METHOD() { }
+
+  Ref<WasmModule> ResourceFormatLoaderWasm::load_module(const String &path, godot_error* error) {
+    // Prefer precompiled artifact packed at export
+    Ref<WasmModule> resource;
+    INSTANTIATE_REF(resource);
+    const String native_path = path + WASM_NATIVE_EXTENSION;
+    const PackedByteArray native = FILE_EXISTS(native_path) ? FileAccess::get_file_as_bytes(native_path) : PackedByteArray();
+    const PackedByteArray bytecode = FileAccess::get_file_as_bytes(path);
+    *error = bytecode.size() ? resource->compile(bytecode, native) : ERR_FILE_CANT_READ;
+    FAIL_IF(*error != OK, "Failed to load module " + path, Ref<WasmModule>());
+    return resource;
+  }
+
+  #ifdef GODOT_MODULE
+    Ref<Resource> ResourceFormatLoaderWasm::load(const String &path, const String &original_path, Error* error, bool use_sub_threads, float* progress, CacheMode cache_mode) {
+      godot_error err;
+      Ref<WasmModule> resource = load_module(path, &err);
+      if (error) *error = err;
+      return resource;
+    }
+
+    void ResourceFormatLoaderWasm::get_recognized_extensions(List<String>* extensions) const {
+      extensions->push_back("wasm");
+    }
+  #else
+    Variant ResourceFormatLoaderWasm::_load(const String &path, const String &original_path, bool use_sub_threads, int32_t cache_mode) const {
+      godot_error err;
+      Ref<WasmModule> resource = load_module(path, &err);
+      if (err != OK) return err;
+      return resource;
+    }
+
+    PackedStringArray ResourceFormatLoaderWasm::_get_recognized_extensions() const {
+      PackedStringArray extensions;
+      extensions.append("wasm");
+      return extensions;
+    }
+  #endif
+
+  bool ResourceFormatLoaderWasm::INTERFACE_HANDLES_TYPE {
+    return type == StringName("WasmModule");
+  }
+
+  String ResourceFormatLoaderWasm::INTERFACE_GET_RESOURCE_TYPE {
+    return path.get_extension().to_lower() == "wasm" ? "WasmModule" : "";
+  }
+}
@@ -0,0 +1,56 @@
+#ifndef WASM_MODULE_H
+#define WASM_MODULE_H
+
+#include "wasm.h"
+#include "defs.h"
+
+#define WASM_NATIVE_EXTENSION ".native" // Suffix of precompiled artifact packed alongside a .wasm file
+
+#ifdef GODOT_MODULE
+  #define INTERFACE_HANDLES_TYPE handles_type(const String &type) const
+  #define INTERFACE_GET_RESOURCE_TYPE get_resource_type(const String &path) const
+#else
+  #define INTERFACE_HANDLES_TYPE _handles_type(const StringName &type) const
+  #define INTERFACE_GET_RESOURCE_TYPE _get_resource_type(const String &path) const
+#endif
+
+namespace godot {
+  class WasmModule : public Resource {
+    GDCLASS(WasmModule, Resource);
+
+    private:
+      wasm_module_t* module; // Engine-wide; shared by instances in any store
+      PackedByteArray bytecode;
+      bool precompiled;
+
+    public:
+      static void REGISTRATION_METHOD();
+      WasmModule();
+      ~WasmModule();
+      void _init();
+      godot_error compile(const PackedByteArray &bytecode, const PackedByteArray &native);
+      const wasm_module_t* get_module() const;
+      PackedByteArray get_bytecode() const;
+      bool is_precompiled() const;
+      static PackedByteArray precompile(const PackedByteArray &bytecode);
+  };
+
+  class ResourceFormatLoaderWasm : public ResourceFormatLoader {
+    GDCLASS(ResourceFormatLoaderWasm, ResourceFormatLoader);
+
+    public:
+      static void REGISTRATION_METHOD();
+      static Ref<WasmModule> load_module(const String &path, godot_error* error);
+      #ifdef GODOT_MODULE
+        Ref<Resource> load(const String &path, const String &original_path, Error* error, bool use_sub_threads, float* progress, CacheMode cache_mode) override;
+        void get_recognized_extensions(List<String>* extensions) const override;
+      #else
+        Variant _load(const String &path, const String &original_path, bool use_sub_threads, int32_t cache_mode) const override;
+        PackedStringArray _get_recognized_extensions() const override;
+      #endif
+      bool INTERFACE_HANDLES_TYPE override;
+      String INTERFACE_GET_RESOURCE_TYPE override;
+  };
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include <chrono>
+#include "wasm-profiler.h"
+#include "defer.h"
+
+#define FRAME_SEPARATOR ";"
+#define TRAP_FRAME "[trap]" // Root frame of trap backtraces such that they are not mistaken for timing samples
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      String join(const std::vector<String> &frames) {
+        String collapsed;
+        for (const auto &frame: frames) collapsed += (collapsed.is_empty() ? "" : FRAME_SEPARATOR) + frame;
+        return collapsed;
+      }
+    }
+
+    Profiler::Profiler() {
+      running = false;
+    }
+
+    Profiler::~Profiler() {
+      stop();
+    }
+
+    void Profiler::start(uint32_t frequency) {
+      if (running) return;
+      running = true;
+      std::chrono::microseconds interval(1000000 / MAX(frequency, 1u));
+      thread = std::thread([this, interval]() {
+        while (running) {
+          std::this_thread::sleep_for(interval);
+          sample();
+        }
+      });
+    }
+
+    String Profiler::stop() {
+      // Returns samples as collapsed stacks suitable for flame graphs
+      if (running) {
+        running = false;
+        thread.join();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      String collapsed;
+      for (const auto &it: samples) collapsed += it.first + " " + String::num_uint64(it.second) + "\n";
+      for (const auto &it: traps) collapsed += TRAP_FRAME FRAME_SEPARATOR + it.first + " " + String::num_uint64(it.second) + "\n";
+      samples.clear();
+      traps.clear();
+      return collapsed;
+    }
+
+    void Profiler::sample() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stack.empty()) return; // Idle
+      samples[join(stack)]++;
+    }
+
+    void Profiler::push(const String &frame) {
+      std::lock_guard<std::mutex> lock(mutex);
+      stack.push_back(frame);
+    }
+
+    void Profiler::pop() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!stack.empty()) stack.pop_back();
+    }
+
+    void Profiler::record_trap(const wasm_trap_t* trap, const std::map<uint32_t, String> &names) {
+      // Record guest frames of a trap backtrace symbolized via the name section
+      wasm_frame_vec_t frames;
+      DEFER(wasm_frame_vec_delete(&frames));
+      wasm_trap_trace(trap, &frames);
+      std::lock_guard<std::mutex> lock(mutex);
+      std::vector<String> trace = stack;
+      for (size_t i = frames.size; i > 0; i--) { // Outermost frame last
+        uint32_t index = wasm_frame_func_index(frames.data[i - 1]);
+        trace.push_back(names.count(index) ? names.at(index) : "func[" + String::num_uint64(index) + "]");
+      }
+      traps[join(trace)]++;
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef GODOT_WASM_PROFILER_H
+#define GODOT_WASM_PROFILER_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "wasm.h"
+#include "defs.h"
+
+namespace godot {
+  namespace godot_wasm {
+    // Samples the stack of host/guest boundary frames at a fixed frequency
+    // Guest-internal frames are unavailable via the Wasm C API outside of trap backtraces
+    class Profiler {
+      private:
+        std::mutex mutex; // Guards stack and samples against the sampling thread
+        std::vector<String> stack;
+        std::map<String, uint64_t> samples; // Collapsed stack to sample count
+        std::map<String, uint64_t> traps; // Collapsed trap backtrace to trap count; kept apart from timing samples
+        std::thread thread;
+        std::atomic<bool> running;
+        void sample();
+
+      public:
+        Profiler();
+        ~Profiler();
+        void start(uint32_t frequency);
+        String stop();
+        void push(const String &frame);
+        void pop();
+        void record_trap(const wasm_trap_t* trap, const std::map<uint32_t, String> &names);
+    };
+  }
+}
+
+#endif
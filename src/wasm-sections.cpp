@@ -0,0 +1,274 @@
+#include <vector>
+#include "wasm-sections.h"
+
+#define NAME_SECTION_FUNCTIONS 1 // Function names subsection of name custom section
+#define SECTION_CUSTOM 0
+#define SECTION_IMPORT 2
+#define SECTION_GLOBAL 6
+#define SECTION_EXPORT 7
+#define SECTION_START 8
+#define SECTION_CODE 10
+#define EXTERN_TABLE 1
+#define EXTERN_GLOBAL 3
+#define OPCODE_END 0x0b
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      bool read_leb(const uint8_t* data, size_t size, size_t &position, uint32_t &value) {
+        // Unsigned LEB128 of at most 32 bits
+        value = 0;
+        for (uint8_t shift = 0; shift < 35; shift += 7) {
+          if (position >= size) return false;
+          uint8_t byte = data[position++];
+          value |= (uint32_t)(byte & 0x7f) << shift;
+          if (!(byte & 0x80)) return true;
+        }
+        return false;
+      }
+
+      bool read_name(const uint8_t* data, size_t size, size_t &position, String &name) {
+        uint32_t length;
+        if (!read_leb(data, size, position, length) || length > size - position) return false;
+        name = String::utf8((const char*)data + position, length);
+        position += length;
+        return true;
+      }
+
+      bool skip_leb(const uint8_t* data, size_t size, size_t &position) {
+        // LEB128 of any width e.g. i64 constants
+        while (position < size) if (!(data[position++] & 0x80)) return true;
+        return false;
+      }
+
+      bool skip_limits(const uint8_t* data, size_t size, size_t &position) {
+        if (position >= size) return false;
+        const uint8_t flags = data[position++];
+        if (!skip_leb(data, size, position)) return false; // Minimum
+        return !(flags & 1) || skip_leb(data, size, position); // Maximum
+      }
+
+      bool skip_expression(const uint8_t* data, size_t size, size_t &position) {
+        // Constant expression of a global initializer
+        while (position < size) {
+          const uint8_t opcode = data[position++];
+          switch (opcode) {
+            case OPCODE_END: return true;
+            case 0x41: case 0x42: case 0x23: case 0xd2: // i32.const, i64.const, global.get, ref.func
+              if (!skip_leb(data, size, position)) return false;
+              break;
+            case 0x43: position += 4; break; // f32.const
+            case 0x44: position += 8; break; // f64.const
+            case 0xd0: position += 1; break; // ref.null
+            case 0xfd: // v128.const
+              if (!skip_leb(data, size, position)) return false;
+              position += 16;
+              break;
+            case 0x6a: case 0x6b: case 0x6c: case 0x7c: case 0x7d: case 0x7e: break; // Extended constant arithmetic
+            default: return false;
+          }
+        }
+        return false;
+      }
+
+      bool skip_value_type(const uint8_t* data, size_t size, size_t &position) {
+        // Value type or block type; reference types with explicit nullability are followed by a heap type
+        if (position >= size) return false;
+        const uint8_t type = data[position];
+        if (!skip_leb(data, size, position)) return false;
+        return (type != 0x63 && type != 0x64) || skip_leb(data, size, position);
+      }
+
+      bool skip_memarg(const uint8_t* data, size_t size, size_t &position) {
+        uint32_t align;
+        if (!read_leb(data, size, position, align)) return false;
+        if ((align & 0x40) && !skip_leb(data, size, position)) return false; // Memory index
+        return skip_leb(data, size, position); // Offset
+      }
+
+      bool skip_bytes(size_t size, size_t &position, size_t count) {
+        position += count;
+        return position <= size;
+      }
+
+      bool skip_instruction(const uint8_t* data, size_t size, size_t &position, bool &tables) {
+        // Instruction of a function body; flags table mutation and fails on unknown opcodes e.g. GC
+        if (position >= size) return false;
+        const uint8_t opcode = data[position++];
+        uint32_t count, subopcode;
+        switch (opcode) {
+          case 0x00: case 0x01: case 0x05: case 0x0a: case 0x0b: case 0x0f: case 0x19: case 0x1a: case 0x1b: case 0xd1: case 0xd3: case 0xd4:
+            return true;
+          case 0x02: case 0x03: case 0x04: case 0x06: // block, loop, if, try
+            return skip_value_type(data, size, position);
+          case 0x07: case 0x08: case 0x09: case 0x0c: case 0x0d: case 0x10: case 0x12: case 0x14: case 0x15: case 0x18:
+          case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x3f: case 0x40: case 0x41: case 0x42:
+          case 0xd0: case 0xd2: case 0xd5: case 0xd6:
+            return skip_leb(data, size, position);
+          case 0x26: // table.set
+            tables = true;
+            return skip_leb(data, size, position);
+          case 0x0e: // br_table
+            if (!read_leb(data, size, position, count)) return false;
+            for (uint32_t i = 0; i <= count; i++) if (!skip_leb(data, size, position)) return false; // Labels and default
+            return true;
+          case 0x11: case 0x13: // call_indirect, return_call_indirect
+            return skip_leb(data, size, position) && skip_leb(data, size, position);
+          case 0x1c: // select with types
+            if (!read_leb(data, size, position, count)) return false;
+            for (uint32_t i = 0; i < count; i++) if (!skip_value_type(data, size, position)) return false;
+            return true;
+          case 0x1f: // try_table
+            if (!skip_value_type(data, size, position) || !read_leb(data, size, position, count)) return false;
+            for (uint32_t i = 0; i < count; i++) {
+              if (position >= size) return false;
+              if (data[position++] < 2 && !skip_leb(data, size, position)) return false; // Tag of catch and catch_ref
+              if (!skip_leb(data, size, position)) return false; // Label
+            }
+            return true;
+          case 0x43: return skip_bytes(size, position, 4); // f32.const
+          case 0x44: return skip_bytes(size, position, 8); // f64.const
+          case 0xfc: // Saturating truncation, bulk memory, and table instructions
+            if (!read_leb(data, size, position, subopcode)) return false;
+            switch (subopcode) {
+              case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7: return true;
+              case 9: case 11: case 13: case 16: return skip_leb(data, size, position);
+              case 8: case 10: return skip_leb(data, size, position) && skip_leb(data, size, position);
+              case 12: case 14: // table.init, table.copy
+                tables = true;
+                return skip_leb(data, size, position) && skip_leb(data, size, position);
+              case 15: case 17: // table.grow, table.fill
+                tables = true;
+                return skip_leb(data, size, position);
+              default: return false;
+            }
+          case 0xfd: // SIMD
+            if (!read_leb(data, size, position, subopcode)) return false;
+            if (subopcode <= 0x0b || subopcode == 0x5c || subopcode == 0x5d) return skip_memarg(data, size, position);
+            if (subopcode == 0x0c || subopcode == 0x0d) return skip_bytes(size, position, 16); // v128.const, i8x16.shuffle
+            if (subopcode >= 0x15 && subopcode <= 0x22) return skip_bytes(size, position, 1); // Lane
+            if (subopcode >= 0x54 && subopcode <= 0x5b) return skip_memarg(data, size, position) && skip_bytes(size, position, 1);
+            return true;
+          case 0xfe: // Atomics
+            if (!read_leb(data, size, position, subopcode)) return false;
+            return subopcode == 0x03 ? skip_bytes(size, position, 1) : skip_memarg(data, size, position); // atomic.fence
+          default:
+            if (opcode >= 0x28 && opcode <= 0x3e) return skip_memarg(data, size, position); // Loads and stores
+            return opcode >= 0x45 && opcode <= 0xc4; // Numeric
+        }
+      }
+
+      bool scan_code(const uint8_t* data, size_t size, size_t &position, bool &tables) {
+        // Function bodies of code section; stops at the first table mutation
+        uint32_t count;
+        if (!read_leb(data, size, position, count)) return false;
+        for (uint32_t i = 0; i < count && !tables; i++) {
+          uint32_t length, locals;
+          if (!read_leb(data, size, position, length) || length > size - position) return false;
+          const size_t end = position + length;
+          if (!read_leb(data, end, position, locals)) return false;
+          for (uint32_t j = 0; j < locals; j++) if (!skip_leb(data, end, position) || !skip_value_type(data, end, position)) return false;
+          while (position < end && !tables) if (!skip_instruction(data, end, position, tables)) return false;
+          position = end;
+        }
+        if (tables) position = size;
+        return true;
+      }
+    }
+
+    std::map<uint32_t, String> parse_function_names(const uint8_t* data, size_t size) {
+      // Function names from the name custom section; empty if absent or malformed
+      std::map<uint32_t, String> names;
+      size_t position = 8; // Magic and version
+      while (position < size) {
+        uint8_t id = data[position++];
+        uint32_t length;
+        if (!read_leb(data, size, position, length) || length > size - position) break;
+        const size_t end = position + length;
+        String section;
+        if (id != SECTION_CUSTOM || !read_name(data, end, position, section) || section != "name") {
+          position = end;
+          continue;
+        }
+        while (position < end) { // Subsections
+          uint8_t subsection = data[position++];
+          uint32_t subsection_length, count;
+          if (!read_leb(data, end, position, subsection_length) || subsection_length > end - position) return names;
+          const size_t subsection_end = position + subsection_length;
+          if (subsection != NAME_SECTION_FUNCTIONS || !read_leb(data, subsection_end, position, count)) {
+            position = subsection_end;
+            continue;
+          }
+          for (uint32_t i = 0; i < count; i++) {
+            uint32_t index;
+            String name;
+            if (!read_leb(data, subsection_end, position, index) || !read_name(data, subsection_end, position, name)) return names;
+            names[index] = name;
+          }
+          position = subsection_end;
+        }
+        break;
+      }
+      return names;
+    }
+
+    instance_state parse_instance_state(const uint8_t* data, size_t size) {
+      // Mutable globals, tables, and start function; sections are ordered such that globals are known before exports
+      instance_state state;
+      std::vector<bool> mutable_globals; // By global index; imported globals first
+      size_t position = 8; // Magic and version
+      while (position < size) {
+        const uint8_t id = data[position++];
+        uint32_t length, count;
+        if (!read_leb(data, size, position, length) || length > size - position) break;
+        const size_t end = position + length;
+        if (id == SECTION_START) state.start = true;
+        if (id == SECTION_CODE) state.valid = scan_code(data, end, position, state.tables);
+        if (id != SECTION_IMPORT && id != SECTION_GLOBAL && id != SECTION_EXPORT) {
+          if (!state.valid) return state;
+          position = end;
+          continue;
+        }
+        if (!read_leb(data, end, position, count)) break;
+        for (uint32_t i = 0; i < count && state.valid; i++) {
+          String module, name;
+          if (id == SECTION_IMPORT) {
+            if (!read_name(data, end, position, module) || !read_name(data, end, position, name) || position >= end) break;
+            switch (data[position++]) {
+              case 0: state.valid = skip_leb(data, end, position); break; // Function type index
+              case EXTERN_TABLE: // Reference type and limits
+                state.tables = true;
+                state.valid = ++position < end && skip_limits(data, end, position);
+                break;
+              case 2: state.valid = skip_limits(data, end, position); break;
+              case EXTERN_GLOBAL:
+                state.valid = position + 2 <= end;
+                if (state.valid) mutable_globals.push_back(data[position + 1] == 1);
+                position += 2;
+                break;
+              default: state.valid = false;
+            }
+          } else if (id == SECTION_GLOBAL) {
+            state.valid = position + 2 <= end;
+            if (state.valid) mutable_globals.push_back(data[position + 1] == 1);
+            position += 2;
+            state.valid = state.valid && skip_expression(data, end, position);
+          } else { // Export
+            uint32_t index;
+            if (!read_name(data, end, position, name) || position >= end) break;
+            const uint8_t kind = data[position++];
+            state.valid = read_leb(data, end, position, index);
+            if (state.valid && kind == EXTERN_GLOBAL && index < mutable_globals.size()) mutable_globals[index] = false; // Transferable
+            if (kind == EXTERN_TABLE) state.tables = true;
+          }
+        }
+        if (!state.valid || position != end) {
+          state.valid = false;
+          return state;
+        }
+      }
+      for (bool hidden: mutable_globals) state.hidden_globals += hidden;
+      return state;
+    }
+  }
+}
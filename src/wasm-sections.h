@@ -0,0 +1,24 @@
+#ifndef GODOT_WASM_SECTIONS_H
+#define GODOT_WASM_SECTIONS_H
+
+#include <map>
+#include "defs.h"
+
+namespace godot {
+  namespace godot_wasm {
+    // Module state held by an instance outside of linear memory and exported globals
+    struct instance_state {
+      bool start; // Module declares a start function
+      uint32_t hidden_globals; // Mutable globals that are not exported; includes imported globals
+      bool tables; // Tables that are imported, exported, or modified by instructions; elements can not be transferred
+      bool valid; // False if sections are malformed
+      instance_state(): start(false), hidden_globals(0), tables(false), valid(true) { }
+    };
+
+    // Parsed from module binary as the Wasm C API exposes neither names nor internal globals
+    std::map<uint32_t, String> parse_function_names(const uint8_t* data, size_t size);
+    instance_state parse_instance_state(const uint8_t* data, size_t size);
+  }
+}
+
+#endif
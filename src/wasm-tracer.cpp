@@ -0,0 +1,115 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "wasm-tracer.h"
+
+#define TRACE_BUFFER_EVENTS 65536 // Per thread; oldest events are overwritten
+
+namespace godot {
+  namespace godot_wasm {
+    namespace {
+      struct TraceEvent {
+        const char* name;
+        uint64_t timestamp; // Nanoseconds
+        char phase; // B or E
+      };
+
+      struct TraceBuffer {
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> head; // Written only by owning thread
+        uint64_t base; // Head when tracing last started; events before are discarded by dump
+        uint64_t thread;
+        TraceBuffer(uint64_t thread): events(TRACE_BUFFER_EVENTS), head(0), base(0), thread(thread) { }
+      };
+
+      std::mutex registry_mutex; // Guards buffer registration, bases, and interned names; not held while recording
+      uint64_t start_time = 0; // Events recorded concurrently with start may land after base but predate it
+      std::vector<std::unique_ptr<TraceBuffer>> buffers; // Outlive threads so events can be dumped
+      std::set<std::string> names;
+      thread_local TraceBuffer* local_buffer = NULL;
+
+      inline uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      TraceBuffer* get_buffer() {
+        if (local_buffer) return local_buffer;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        buffers.emplace_back(new TraceBuffer(buffers.size() + 1)); // Base of zero as created after start
+        return local_buffer = buffers.back().get();
+      }
+
+      inline void record(const char* name, char phase) {
+        TraceBuffer* buffer = get_buffer();
+        const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        buffer->events[head % TRACE_BUFFER_EVENTS] = { name, now(), phase };
+        buffer->head.store(head + 1, std::memory_order_release);
+      }
+
+      std::string escape(const char* s) {
+        std::string escaped;
+        for (; *s; s++) {
+          if (*s == '"' || *s == '\\') escaped += '\\';
+          if ((unsigned char)*s >= 0x20) escaped += *s;
+        }
+        return escaped;
+      }
+    }
+
+    std::atomic<bool> Tracer::enabled(false);
+
+    void Tracer::start() {
+      // Heads are owned by recording threads so are never reset; earlier events are skipped via base
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      start_time = now();
+      for (auto &buffer: buffers) buffer->base = buffer->head.load(std::memory_order_acquire);
+      enabled = true;
+    }
+
+    void Tracer::stop() {
+      enabled = false;
+    }
+
+    void Tracer::begin(const char* name) {
+      record(name, 'B');
+    }
+
+    void Tracer::end(const char* name) {
+      record(name, 'E');
+    }
+
+    const char* Tracer::intern(const String &name) {
+      // Names referenced by recorded events must remain valid until dumped
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      return names.insert(name.utf8().get_data()).first->c_str();
+    }
+
+    godot_error Tracer::dump(const String &path) {
+      // Chrome trace event format; events recorded concurrently with dumping may be torn
+      std::string json = "{\"traceEvents\":[";
+      bool first = true;
+      {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto &buffer: buffers) {
+          const uint64_t head = buffer->head.load(std::memory_order_acquire);
+          const uint64_t tail = MAX(buffer->base, head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0);
+          for (uint64_t i = tail; i < head; i++) {
+            const TraceEvent &event = buffer->events[i % TRACE_BUFFER_EVENTS];
+            if (event.timestamp < start_time) continue;
+            json += first ? "\n" : ",\n";
+            json += "{\"name\":\"" + escape(event.name) + "\",\"ph\":\"" + event.phase + "\",\"ts\":" + std::to_string(event.timestamp / 1000.0) + ",\"pid\":1,\"tid\":" + std::to_string(buffer->thread) + "}";
+            first = false;
+          }
+        }
+      }
+      json += "\n],\"displayTimeUnit\":\"ns\"}\n";
+      Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+      FAIL_IF(file.is_null(), "Failed to open trace file " + path, ERR_FILE_CANT_WRITE);
+      file->store_string(String::utf8(json.c_str(), json.size()));
+      return OK;
+    }
+  }
+}
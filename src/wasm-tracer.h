@@ -0,0 +1,37 @@
+#ifndef GODOT_WASM_TRACER_H
+#define GODOT_WASM_TRACER_H
+
+#include <atomic>
+#include "defs.h"
+#include "defer.h"
+
+// Record begin and end events for the enclosing scope if tracing is enabled
+#define TRACE_SCOPE(name) ::godot::godot_wasm::TraceScope CONCAT(_trace_, __LINE__)(name)
+
+namespace godot {
+  namespace godot_wasm {
+    // Host/guest boundary events recorded to per-thread ring buffers and dumped in Chrome trace event format
+    class Tracer {
+      public:
+        static std::atomic<bool> enabled;
+        static void start();
+        static void stop();
+        static void begin(const char* name);
+        static void end(const char* name);
+        static const char* intern(const String &name);
+        static godot_error dump(const String &path);
+    };
+
+    struct TraceScope {
+      const char* name; // Must outlive trace; see Tracer::intern
+      TraceScope(const char* name): name(Tracer::enabled.load(std::memory_order_relaxed) ? name : NULL) {
+        if (this->name) Tracer::begin(this->name);
+      }
+      ~TraceScope() {
+        if (name) Tracer::end(name);
+      }
+    };
+  }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "wasmShimNode3d.h"
 #include "defs.h"
 #include "godot-wasm.h"
+#include "wasm-tracer.h"
 #include "../godot-cpp/gen/include/godot_cpp/classes/node3d.hpp"
 
 // NOTE - copy of defines in wasi-shim.cpp. Move this somewhere shareable.
@@ -14,6 +15,7 @@
 
 ///////////////////////////////////////////////////////////////////////////
 #define SHIM_BEGIN(numArgs, numResults) \
+        TRACE_SCOPE(__FUNCTION__);\
         FAIL_IF(args->size != numArgs || results->size != numResults, "Invalid arguments " __FUNCTION__, wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));\
         Wasm* wasm = (Wasm*) env;\
         wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();\
@@ -0,0 +1,212 @@
+#include "wasmShimPhysics3d.h"
+#include "defs.h"
+#include "godot-wasm.h"
+#include "wasm-tracer.h"
+#ifdef GODOT_MODULE
+  #include "scene/3d/node_3d.h"
+  #include "scene/resources/world_3d.h"
+  #include "scene/resources/shape_3d.h"
+  #include "servers/physics_server_3d.h"
+#else
+  #include "godot_cpp/classes/node3d.hpp"
+  #include "godot_cpp/classes/world3d.hpp"
+  #include "godot_cpp/classes/shape3d.hpp"
+  #include "godot_cpp/classes/physics_direct_space_state3d.hpp"
+  #include "godot_cpp/classes/physics_ray_query_parameters3d.hpp"
+  #include "godot_cpp/classes/physics_shape_query_parameters3d.hpp"
+#endif
+
+// NOTE - copy of defines in wasi-shim.cpp. Move this somewhere shareable.
+#define __WASI_ERRNO_SUCCESS (UINT16_C(0)) // No error occurred
+#define __WASI_ERRNO_INVAL (UINT16_C(28)) // Invalid argument
+#define __WASI_ERRNO_IO (UINT16_C(29)) // I/O error
+
+///////////////////////////////////////////////////////////////////////////
+#define SHIM_BEGIN(numArgs, numResults) \
+        FAIL_IF(args->size != numArgs || results->size != numResults, "Invalid arguments " + String(__FUNCTION__), wasi_result(results, __WASI_ERRNO_INVAL, "Invalid arguments\0"));\
+        Wasm* wasm = (Wasm*) env;\
+        wasm_memory_t* memory = wasm->get_memory().ptr()->get_memory();\
+        if (memory == NULL) return wasi_result(results, __WASI_ERRNO_IO, "Invalid memory\0");\
+        byte_t* data = wasm_memory_data(memory);\
+        uint64_t nodeID = args->data[0].of.i64;\
+        uint64_t requestsOffset = args->data[1].of.i64;\
+        uint64_t count = args->data[2].of.i64;\
+        uint64_t resultsOffset = args->data[3].of.i64;\
+        PhysicsDirectSpaceState3D* space = get_space_state(nodeID);\
+        if (space == NULL) return wasi_result(results, __WASI_ERRNO_INVAL, "Invalid space\0");
+
+///////////////////////////////////////////////////////////////////////////
+#define SHIM_CHECK_BOUNDS(requestType, resultType) \
+        if (!in_bounds(memory, requestsOffset, count, sizeof(requestType)) || !in_bounds(memory, resultsOffset, count, sizeof(resultType)))\
+            return wasi_result(results, __WASI_ERRNO_INVAL, "Out of bounds\0");
+
+///////////////////////////////////////////////////////////////////////////
+#define SHIM_END(value) \
+        results->data[0].kind = WASM_I32;\
+        results->data[0].of.i32 = (int32_t) value;\
+        return NULL;
+
+namespace godot
+{
+    // Defined in wasmShimNode3d.cpp
+    wasm_trap_t* wasi_result(wasm_val_vec_t* results, int32_t value, const char* message);
+
+    namespace
+    {
+        static_assert(sizeof(WasmShimPhysics3D::RayRequest) == 32, "Unexpected ray request layout");
+        static_assert(sizeof(WasmShimPhysics3D::RayHit) == 40, "Unexpected ray hit layout");
+        static_assert(sizeof(WasmShimPhysics3D::ShapeCastRequest) == 80, "Unexpected shape cast request layout");
+        static_assert(sizeof(WasmShimPhysics3D::ShapeCastResult) == 8, "Unexpected shape cast result layout");
+
+        PhysicsDirectSpaceState3D* get_space_state(uint64_t nodeID)
+        {
+            Node3D* node = (Node3D*) ObjectDB::get_instance(ObjectID(nodeID));
+            if (node == NULL) return NULL;
+            Ref<World3D> world = node->get_world_3d();
+            return world.is_valid() ? world->get_direct_space_state() : NULL;
+        }
+
+        bool in_bounds(wasm_memory_t* memory, uint64_t offset, uint64_t count, size_t stride)
+        {
+            uint64_t size = wasm_memory_data_size(memory);
+            return offset <= size && count <= (size - offset) / stride;
+        }
+
+        uint32_t intersect_batch(PhysicsDirectSpaceState3D* space, const WasmShimPhysics3D::RayRequest* requests, WasmShimPhysics3D::RayHit* hits, uint64_t count)
+        {
+            // Queries share the scratch buffers of the space so are made serially
+            #ifdef GODOT_MODULE
+            PhysicsDirectSpaceState3D::RayParameters params;
+            PhysicsDirectSpaceState3D::RayResult result;
+            #else
+            Ref<PhysicsRayQueryParameters3D> params; // Reused across the batch to avoid per ray allocation
+            params.instantiate();
+            #endif
+            uint32_t hitCount = 0;
+            for (uint64_t i = 0; i < count; i++)
+            {
+                const WasmShimPhysics3D::RayRequest& request = requests[i];
+                WasmShimPhysics3D::RayHit hit = {};
+                #ifdef GODOT_MODULE
+                // Native overload fills a result struct rather than a Dictionary
+                params.from = request.from;
+                params.to = request.to;
+                params.collision_mask = request.mask;
+                params.collide_with_bodies = request.flags & WasmShimPhysics3D::RAY_COLLIDE_WITH_BODIES;
+                params.collide_with_areas = request.flags & WasmShimPhysics3D::RAY_COLLIDE_WITH_AREAS;
+                params.hit_from_inside = request.flags & WasmShimPhysics3D::RAY_HIT_FROM_INSIDE;
+                params.hit_back_faces = request.flags & WasmShimPhysics3D::RAY_HIT_BACK_FACES;
+                if (space->intersect_ray(params, result))
+                {
+                    hit.position = result.position;
+                    hit.normal = result.normal;
+                    hit.collider_id = (uint64_t) result.collider_id;
+                    hit.shape = result.shape;
+                    hit.hit = 1;
+                    hitCount++;
+                }
+                #else
+                // Only the Dictionary overload is exposed to extensions
+                params->set_from(request.from);
+                params->set_to(request.to);
+                params->set_collision_mask(request.mask);
+                params->set_collide_with_bodies(request.flags & WasmShimPhysics3D::RAY_COLLIDE_WITH_BODIES);
+                params->set_collide_with_areas(request.flags & WasmShimPhysics3D::RAY_COLLIDE_WITH_AREAS);
+                params->set_hit_from_inside(request.flags & WasmShimPhysics3D::RAY_HIT_FROM_INSIDE);
+                params->set_hit_back_faces(request.flags & WasmShimPhysics3D::RAY_HIT_BACK_FACES);
+                Dictionary result = space->intersect_ray(params);
+                if (!result.is_empty())
+                {
+                    hit.position = result["position"];
+                    hit.normal = result["normal"];
+                    hit.collider_id = (uint64_t) (int64_t) result["collider_id"];
+                    hit.shape = (int32_t) result["shape"];
+                    hit.hit = 1;
+                    hitCount++;
+                }
+                #endif
+                memcpy(hits + i, &hit, sizeof(hit));
+            }
+            return hitCount;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Dictionary intersect_ray(const Ref<PhysicsRayQueryParameters3D>& parameters);
+    // (nodeID, requestsMemoryOffset, count, hitsMemoryOffset) [I64, I64, I64, I64] -> [I32]
+    // Returns the number of rays that hit
+    wasm_trap_t* WasmShimPhysics3D::intersect_rays(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results)
+    {
+        TRACE_SCOPE(__FUNCTION__);
+        SHIM_BEGIN(4, 1)
+        SHIM_CHECK_BOUNDS(RayRequest, RayHit)
+        const RayRequest* requests = (const RayRequest*) (data + requestsOffset);
+        RayHit* hits = (RayHit*) (data + resultsOffset);
+        uint32_t hitCount = intersect_batch(space, requests, hits, count);
+        SHIM_END(hitCount)
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // PackedFloat32Array cast_motion(const Ref<PhysicsShapeQueryParameters3D>& parameters);
+    // (nodeID, requestsMemoryOffset, count, resultsMemoryOffset) [I64, I64, I64, I64] -> [I32]
+    // Returns the number of shapes that would collide along their motion
+    wasm_trap_t* WasmShimPhysics3D::cast_shapes(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results)
+    {
+        TRACE_SCOPE(__FUNCTION__);
+        SHIM_BEGIN(4, 1)
+        SHIM_CHECK_BOUNDS(ShapeCastRequest, ShapeCastResult)
+        const ShapeCastRequest* requests = (const ShapeCastRequest*) (data + requestsOffset);
+        ShapeCastResult* casts = (ShapeCastResult*) (data + resultsOffset);
+        #ifdef GODOT_MODULE
+        PhysicsDirectSpaceState3D::ShapeParameters params;
+        #else
+        Ref<PhysicsShapeQueryParameters3D> params;
+        params.instantiate();
+        #endif
+        uint32_t collisionCount = 0;
+        for (uint64_t i = 0; i < count; i++)
+        {
+            const ShapeCastRequest& request = requests[i];
+            ShapeCastResult cast = { 1.0f, 1.0f };
+            Shape3D* shape = Object::cast_to<Shape3D>(ObjectDB::get_instance(ObjectID(request.shape_id)));
+            #ifdef GODOT_MODULE
+            if (shape != NULL)
+            {
+                params.shape_rid = shape->get_rid();
+                params.transform = request.transform;
+                params.motion = request.motion;
+                params.collision_mask = request.mask;
+                params.margin = request.margin;
+                params.collide_with_bodies = request.flags & RAY_COLLIDE_WITH_BODIES;
+                params.collide_with_areas = request.flags & RAY_COLLIDE_WITH_AREAS;
+                real_t safe, unsafe;
+                if (space->cast_motion(params, safe, unsafe))
+                {
+                    cast.safe = safe;
+                    cast.unsafe = unsafe;
+                }
+            }
+            #else
+            if (shape != NULL)
+            {
+                params->set_shape(Ref<Resource>(shape));
+                params->set_transform(request.transform);
+                params->set_motion(request.motion);
+                params->set_collision_mask(request.mask);
+                params->set_margin(request.margin);
+                params->set_collide_with_bodies(request.flags & RAY_COLLIDE_WITH_BODIES);
+                params->set_collide_with_areas(request.flags & RAY_COLLIDE_WITH_AREAS);
+                PackedFloat32Array fractions = space->cast_motion(params);
+                if (fractions.size() == 2)
+                {
+                    cast.safe = fractions[0];
+                    cast.unsafe = fractions[1];
+                }
+            }
+            #endif
+            if (cast.unsafe < 1.0f) collisionCount++;
+            memcpy(casts + i, &cast, sizeof(cast));
+        }
+        SHIM_END(collisionCount)
+    }
+}
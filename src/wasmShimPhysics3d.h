@@ -0,0 +1,75 @@
+#ifndef WASM_SHIM_PHYSICS_3D_H
+#define WASM_SHIM_PHYSICS_3D_H
+
+#include "wasm.h"
+#include "defs.h"
+
+#ifndef SHIMDECL
+#define SHIMDECL(funcName) static wasm_trap_t* funcName(void* env, const wasm_val_vec_t* args, wasm_val_vec_t* results);
+#endif
+
+namespace godot
+{
+    // Batched PhysicsDirectSpaceState3D queries
+    // Requests are read from and results written to linear memory using the fixed layouts below
+    // The space is that of the world of the Node3D identified by nodeID
+    // Layouts assume single precision (real_t is float) builds
+    class WasmShimPhysics3D
+    {
+        public:
+
+            // Ray request flags
+            static const uint32_t RAY_COLLIDE_WITH_BODIES = 1 << 0;
+            static const uint32_t RAY_COLLIDE_WITH_AREAS = 1 << 1;
+            static const uint32_t RAY_HIT_FROM_INSIDE = 1 << 2;
+            static const uint32_t RAY_HIT_BACK_FACES = 1 << 3;
+
+            // Ray request, 32 bytes
+            struct RayRequest
+            {
+                Vector3 from;
+                Vector3 to;
+                uint32_t mask;
+                uint32_t flags;
+            };
+
+            // Ray hit record, 40 bytes
+            // hit is zero and remaining fields are zeroed if the ray did not collide
+            struct RayHit
+            {
+                Vector3 position;
+                Vector3 normal;
+                uint64_t collider_id;
+                int32_t shape;
+                uint32_t hit;
+            };
+
+            // Shape cast request, 80 bytes
+            // shape_id is the instance ID of a Shape3D resource
+            struct ShapeCastRequest
+            {
+                uint64_t shape_id;
+                Transform3D transform;
+                Vector3 motion;
+                uint32_t mask;
+                uint32_t flags;
+                float margin;
+            };
+
+            // Shape cast result, 8 bytes
+            // Fractions of motion that are safe and unsafe; both 1.0 if no collision
+            struct ShapeCastResult
+            {
+                float safe;
+                float unsafe;
+            };
+
+            // Array intersect_ray(PhysicsRayQueryParameters3D parameters) for each request
+            SHIMDECL(intersect_rays)
+
+            // PackedFloat32Array cast_motion(PhysicsShapeQueryParameters3D parameters) for each request
+            SHIMDECL(cast_shapes)
+    };
+}
+
+#endif